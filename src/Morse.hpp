@@ -1,6 +1,10 @@
 #ifndef HEADER_GUARD_BOOP_BEEPER_MORSE_HPP_INCLUDED
 #define HEADER_GUARD_BOOP_BEEPER_MORSE_HPP_INCLUDED
 
+#include <cctype>
+#include <cstddef>
+#include <chrono>
+
 // Morse table:
 // '.' - dot
 // '-' - dash
@@ -61,6 +65,20 @@ const MorseCode MORSE_UNKNOWN           = "!";
 // Morse unit of time
 const unsigned MORSE_TIME_UNIT = 100; // milliseconds
 
+// A morse symbol, scheduled to be shown at a moment of time:
+using MorseClock = std::chrono::steady_clock;
+
+struct MorseElement
+{
+	MorseSymbol            symbol;
+	unsigned               units;
+	MorseClock::time_point start;
+
+	// For latency measurements: when its character was read and encoded (zero, if unknown)
+	MorseClock::time_point input;
+	MorseClock::time_point encoded;
+};
+
 // Translating to morse:
 MorseCode morseFromChar(char toConvert)
 {
@@ -73,4 +91,50 @@ MorseCode morseFromChar(char toConvert)
 	return MORSE_UNKNOWN;
 }
 
+// Duration of a morse symbol in units of time:
+unsigned morseSymbolUnits(MorseSymbol morseSymbol)
+{
+	switch (morseSymbol)
+	{
+		case '.': return 1;
+		case '-': return 3;
+		case '_': return 1;
+		case ' ': return 3;
+		case '<': return 7;
+		case '!': return 3;
+		default:  return 0;
+	}
+}
+
+// Translating a stream of characters to a stream of morse symbols:
+class MorseEncoder
+{
+private:
+	bool previousWasSentenceSpace_;
+
+public:
+	MorseEncoder() :
+		previousWasSentenceSpace_ (true)
+	{}
+
+	// Calls sink(MorseSymbol) for every symbol of the character, separators included
+	template <typename Sink>
+	void encode(char toEncode, Sink&& sink)
+	{
+		auto curMorseCode = morseFromChar(toEncode);
+
+		if (!previousWasSentenceSpace_ && curMorseCode[0] != '<') sink(' ');
+
+		for (size_t i = 0; curMorseCode[i] != '\0'; ++i)
+		{
+			if (curMorseCode[i] == '<') previousWasSentenceSpace_ = true;
+			else previousWasSentenceSpace_ = false;
+
+			sink(curMorseCode[i]);
+
+			if (curMorseCode[i + 1] != '\0') sink('_');
+		}
+	}
+};
+
 #endif  // HEADER_GUARD_BOOP_BEEPER_MORSE_HPP_INCLUDED
\ No newline at end of file
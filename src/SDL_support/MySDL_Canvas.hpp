@@ -0,0 +1,1367 @@
+#ifndef MY_SDL_CANVAS_HPP_INCLUDED
+#define MY_SDL_CANVAS_HPP_INCLUDED
+
+//----------------------------------------------------------------------------
+//{ Includes
+//----------------------------------------------------------------------------
+
+    #include <iostream>
+    #include <iomanip>
+    #include <algorithm>
+    #include <cstdlib>
+    #include <cstring>
+    #include <stdexcept>
+    #include <string>
+    #include <vector>
+
+    #include <SDL2/SDL.h>
+
+    #include "MySDL_Pixels.hpp"
+    #include "MySDL_DrawList.hpp"
+    #include "MySDL_ThreadPool.hpp"
+
+//}
+//----------------------------------------------------------------------------
+
+
+namespace MySDL
+{
+
+//----------------------------------------------------------------------------
+//{ Canvas
+//----------------------------------------------------------------------------
+
+    // Parallel rendering: areas smaller than that are not worth waking the workers up
+    const size_t PARALLEL_MIN_PIXELS = 64 * 1024;
+    // More bands than threads, so stealing can even out uneven bands
+    const size_t BANDS_PER_THREAD = 4;
+
+    // Software rasterizer over packed RGBA8888 pixels of a sizeX * sizeY target.
+    // Draws only while pixels are bound (a locked texture, a bitmap), and only inside the bound rectangle.
+    class Canvas
+    {
+        public:
+
+            // Constructor && destructor:
+
+                Canvas(unsigned int sizeX, unsigned int sizeY);
+
+                virtual ~Canvas() = default;
+
+            // Getters && setters:
+
+                size_t getDestSizeX() const;
+                size_t getDestSizeY() const;
+
+                // Splits clear, fills and shaders into row bands processed on the pool (nullptr: all on the caller thread).
+                // The result is the same as without the pool.
+                Canvas& setThreadPool(ThreadPool* pool);
+
+            // Functions:
+
+                // Debugging:
+
+                    virtual void dump() const;
+
+                // Colors:
+
+                    Canvas& setLineColor(const SDL_Color& lineColor);
+                    Canvas& setFillColor(const SDL_Color& fillColor);
+
+                // Rendering:
+
+                    // Clears the locked rectangle
+                    Canvas& clear(const SDL_Color& color);
+                    Canvas& clear();
+
+                    Canvas& fillRect(int x, int y, unsigned int w, unsigned int h, const SDL_Color& color);
+                    Canvas& fillRect(int x, int y, unsigned int w, unsigned int h);
+
+                    // A batch of filled rectangles, drawn in order
+                    Canvas& fillRects(const SDL_Rect* rects, size_t count, const SDL_Color& color);
+                    Canvas& fillRects(const SDL_Rect* rects, size_t count);
+
+                    Canvas& pixel(const int x, const int y, const SDL_Color& color);
+                    Canvas& pixel(const int x, const int y);
+
+                    Canvas& line(int x0, int y0, int x1, int y1, const SDL_Color& color);
+                    Canvas& line(int x0, int y0, int x1, int y1);
+
+                    // Rectangle outline, one pixel wide, inside [x, x + w) x [y, y + h)
+                    Canvas& rect(int x, int y, unsigned int w, unsigned int h, const SDL_Color& color);
+                    Canvas& rect(int x, int y, unsigned int w, unsigned int h);
+
+                    Canvas& circle(const int x, const int y, const unsigned int r, const SDL_Color& color);
+                    Canvas& circle(const int x, const int y, const unsigned int r);
+
+                    Canvas& round(const int x, const int y, const unsigned int r, const SDL_Color& lineColor, const SDL_Color& fillColor);
+                    Canvas& round(const int x, const int y, const unsigned int r);
+
+                    // Anti-aliased (Wu) versions of line() and circle(): every pixel near the ideal curve is blended
+                    // with the color by its coverage, all four channels. Both run in fixed point, no floating point at all.
+                    Canvas& smoothLine(int x0, int y0, int x1, int y1, const SDL_Color& color);
+                    Canvas& smoothLine(int x0, int y0, int x1, int y1);
+
+                    Canvas& smoothCircle(const int x, const int y, const unsigned int r, const SDL_Color& color);
+                    Canvas& smoothCircle(const int x, const int y, const unsigned int r);
+
+                    // Shader: SDL_Color(int x, int y, const SDL_Color& color), inlined into the pixel loop
+                    template <typename Shader>
+                    Canvas& applyShader(int x, int y, unsigned int w, unsigned int h, Shader&& shader);
+
+                    // Draws the list tile by tile, tiles in parallel with a thread pool set.
+                    // With regions given only the tiles touching them are drawn (and nothing is cleared).
+                    Canvas& draw(DrawList& list, const SDL_Rect* regions = nullptr, size_t regionCount = 0);
+
+                    // Row shader: void(int x, int y, Uint32* pixels, unsigned int count), gets a row span of packed pixels at a time.
+                    // With a thread pool set, shaders are called from several threads at once.
+                    template <typename RowShader>
+                    Canvas& applyRowShader(int x, int y, unsigned int w, unsigned int h, RowShader&& shader);
+
+
+                    // Copies a w * h block of pixels with the given pitch (in pixels) to (x, y), a memcpy per row
+                    Canvas& blit(const Uint32* pixels, size_t pitch, unsigned int w, unsigned int h, int x, int y);
+
+        protected:
+
+            // Functions for the owners of the pixels:
+
+                void setSize(unsigned int sizeX, unsigned int sizeY);
+
+                // pixels is the top left pixel of rect, rect has to be inside the target
+                void bind(Uint32* pixels, size_t pitch, const SDL_Rect& rect);
+                void unbind();
+
+                bool isBound() const;
+
+                // The rectangle of the last bind()
+                const SDL_Rect& getBoundRect() const;
+
+        private:
+
+            // Variables:
+
+                unsigned int destSizeX_;
+                unsigned int destSizeY_;
+                
+                Uint32* pixelBuffer_; // Top left pixel of lockRect_
+                size_t  pitch_;       // In pixels
+
+                SDL_Rect lockRect_;
+
+                SDL_Color lineColor_;
+                SDL_Color fillColor_;
+
+                ThreadPool* pool_;
+
+            // Functions, that shouldn't appear anywhere at all:
+
+                Canvas();
+
+                Canvas(const Canvas& canvas);
+                
+                Canvas& operator=(const Canvas& canvas);
+
+            // Functions, that should not appear anywhere outside: 
+
+                Canvas& clearInsecure(const SDL_Color& color);
+
+                Canvas& fillRectInsecure(const int x, const int y, const unsigned int w, const unsigned int h, const SDL_Color& color);
+
+                Canvas& pixelInsecure(const int x, const int y, const SDL_Color& color);
+
+                // These draw only inside clip, which has to be inside the texture; the primitive itself may stick out of it
+
+                Canvas& lineInsecure(int x0, int y0, int x1, int y1, const Uint32 pixel, const SDL_Rect& clip);
+
+                Canvas& rectInsecure(const int x, const int y, const unsigned int w, const unsigned int h, const Uint32 pixel, const SDL_Rect& clip);
+
+                Canvas& circleInsecure(const int x, const int y, const unsigned int r, const Uint32 pixel, const SDL_Rect& clip);
+
+                Canvas& roundInsecure(const int x, const int y, const unsigned int r, const Uint32 linePixel, const Uint32 fillPixel, const SDL_Rect& clip);
+
+                Canvas& smoothLineInsecure(int x0, int y0, int x1, int y1, const Uint32 pixel, const SDL_Rect& clip);
+
+                Canvas& smoothCircleInsecure(const int x, const int y, const unsigned int r, const Uint32 pixel, const SDL_Rect& clip);
+
+                Canvas& commandInsecure(const DrawCommand& command, const SDL_Rect& clip);
+
+                template <typename RowShader>
+                Canvas& applyRowShaderInsecure(const int x, const int y, const unsigned int w, const unsigned int h, RowShader& shader);
+
+            // Helpers:
+
+                // Clips the rectangle to the locked rectangle, false if nothing is left
+                bool clipRect(int& x, int& y, unsigned int& w, unsigned int& h) const;
+
+                // Calls band(int bandY, unsigned int bandH) for row bands covering [y, y + h), in parallel if worth it
+                template <typename BandFunction>
+                void forEachBand(const int y, const unsigned int h, const size_t rowPixels, BandFunction&& band);
+
+                Uint32* pixelAt(const int x, const int y) const;
+
+                // Span [x0, x1] of row y, both ends included
+                void spanInsecure(const int y, const int x0, const int x1, const Uint32 pixel);
+                void spanClipped (const SDL_Rect& clip, const int y, int x0, int x1, const Uint32 pixel);
+
+                // Calls row(int relY, int outer, int inner) for relY in [0, r]: the circle covers |relX| <= outer on rows
+                // y +- relY, its outline is inner < |relX| <= outer (inner is -1 on the last row, i.e. the whole row)
+                template <typename RowFunction>
+                static void forEachCircleRow(const unsigned int r, RowFunction&& row);
+    };
+
+
+    //----------------------------------------------------------------------------
+    //{ Constructor
+    //----------------------------------------------------------------------------
+
+        Canvas::Canvas(unsigned int sizeX, unsigned int sizeY) :
+            destSizeX_   (sizeX),
+            destSizeY_   (sizeY),
+            pixelBuffer_ (nullptr),
+            pitch_       (0),
+            lockRect_    ({0, 0, 0, 0}),
+            lineColor_   ({0, 0, 0, 255}),
+            fillColor_   ({0, 0, 0, 255}),
+            pool_        (nullptr)
+        {}
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Getters && setters:
+    //----------------------------------------------------------------------------
+
+        size_t Canvas::getDestSizeX() const
+        {
+            return destSizeX_;
+        }
+
+        size_t Canvas::getDestSizeY() const
+        {
+            return destSizeY_;
+        } 
+
+        Canvas& Canvas::setThreadPool(ThreadPool* pool)
+        {
+            pool_ = pool;
+
+            return *this;
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Functions
+    //----------------------------------------------------------------------------
+
+        //----------------------------------------------------------------------------
+        //{ Debugging
+        //----------------------------------------------------------------------------
+
+            #ifndef NDEBUG
+
+                void Canvas::dump() const
+                {
+                    std::cout << "\nCanvas::dump:"                  << "\n"
+                              << "destSizeX_   == " << destSizeX_   << "\n"
+                              << "destSizeY_   == " << destSizeY_   << "\n"
+                              << "pixelBuffer_ == " << static_cast<void*>(pixelBuffer_) << "\n"
+                              << "pitch_       == " << pitch_       << "\n"
+                              << "lockRect_    == " << lockRect_.x << " " << lockRect_.y << " " << lockRect_.w << " " << lockRect_.h << "\n"
+                              << std::setfill('0') << std::right 
+                              << "lineColor_   ==" 
+                              << " r" << std::setw(3) << static_cast<int>(lineColor_.r)
+                              << " g" << std::setw(3) << static_cast<int>(lineColor_.g)
+                              << " b" << std::setw(3) << static_cast<int>(lineColor_.b)
+                              << " a" << std::setw(3) << static_cast<int>(lineColor_.a) << "\n"
+                              << "fillColor_   ==" 
+                              << " r" << std::setw(3) << static_cast<int>(fillColor_.r)
+                              << " g" << std::setw(3) << static_cast<int>(fillColor_.g)
+                              << " b" << std::setw(3) << static_cast<int>(fillColor_.b)
+                              << " a" << std::setw(3) << static_cast<int>(fillColor_.a) << "\n"
+                              << std::setfill(' ') << std::left
+                              <<std::endl;
+                }
+
+            #else 
+
+                void Canvas::dump() const {}
+
+            #endif /*NDEBUG*/
+
+        //}
+        //----------------------------------------------------------------------------
+
+
+        //----------------------------------------------------------------------------
+        //{ Binding
+        //----------------------------------------------------------------------------
+
+            void Canvas::setSize(unsigned int sizeX, unsigned int sizeY)
+            {
+                if (pixelBuffer_ != nullptr)
+                {
+                    throw std::string("Canvas::setSize(): pixels are still bound");
+                }
+
+                destSizeX_ = sizeX;
+                destSizeY_ = sizeY;
+            }
+
+            void Canvas::bind(Uint32* pixels, size_t pitch, const SDL_Rect& rect)
+            {
+                pixelBuffer_ = pixels;
+                pitch_       = pitch;
+                lockRect_    = rect;
+            }
+
+            void Canvas::unbind()
+            {
+                pixelBuffer_ = nullptr;
+            }
+
+            bool Canvas::isBound() const
+            {
+                return pixelBuffer_ != nullptr;
+            }
+
+            const SDL_Rect& Canvas::getBoundRect() const
+            {
+                return lockRect_;
+            }
+
+        //}
+        //----------------------------------------------------------------------------
+
+
+        //----------------------------------------------------------------------------
+        //{ Colors
+        //----------------------------------------------------------------------------
+
+            Canvas& Canvas::setLineColor(const SDL_Color& lineColor)
+            {
+                lineColor_ = lineColor;
+
+                return *this;
+            }
+
+            Canvas& Canvas::setFillColor(const SDL_Color& fillColor)
+            {
+                fillColor_ = fillColor;
+
+                return *this;
+            }
+
+        //}
+        //----------------------------------------------------------------------------
+
+
+        //----------------------------------------------------------------------------
+        //{ Helpers
+        //----------------------------------------------------------------------------
+
+            bool Canvas::clipRect(int& x, int& y, unsigned int& w, unsigned int& h) const
+            {
+                SDL_Rect rect = {x, y, static_cast<int>(w), static_cast<int>(h)}, clipped = {};
+
+                if (SDL_IntersectRect(&rect, &lockRect_, &clipped) != SDL_TRUE) return false;
+
+                x = clipped.x;
+                y = clipped.y;
+                w = clipped.w;
+                h = clipped.h;
+
+                return true;
+            }
+
+            template <typename BandFunction>
+            void Canvas::forEachBand(const int y, const unsigned int h, const size_t rowPixels, BandFunction&& band)
+            {
+                if (pool_ == nullptr || pool_->getThreadCount() == 1 || h * rowPixels < PARALLEL_MIN_PIXELS)
+                {
+                    band(y, h);
+
+                    return;
+                }
+
+                size_t bandCount = pool_->getThreadCount() * BANDS_PER_THREAD;
+                if (bandCount > h) bandCount = h;
+
+                unsigned int bandH = static_cast<unsigned int>((h + bandCount - 1) / bandCount);
+
+                pool_->parallelFor
+                (
+                    bandCount,
+                    [&] (size_t index)
+                    {
+                        unsigned int bandY = static_cast<unsigned int>(index) * bandH;
+
+                        if (bandY >= h) return;
+
+                        band(y + static_cast<int>(bandY), bandY + bandH > h ? h - bandY : bandH);
+                    }
+                );
+            }
+
+            void Canvas::spanInsecure(const int y, const int x0, const int x1, const Uint32 pixel)
+            {
+                FillSpan(pixelAt(x0, y), x1 - x0 + 1, pixel);
+            }
+
+            Uint32* Canvas::pixelAt(const int x, const int y) const
+            {
+                return pixelBuffer_ + pitch_ * (y - lockRect_.y) + (x - lockRect_.x);
+            }
+
+            void Canvas::spanClipped(const SDL_Rect& clip, const int y, int x0, int x1, const Uint32 pixel)
+            {
+                if (y < clip.y || y >= clip.y + clip.h) return;
+
+                if (x0 < clip.x) x0 = clip.x;
+                if (x1 >= clip.x + clip.w) x1 = clip.x + clip.w - 1;
+
+                if (x0 > x1) return;
+
+                spanInsecure(y, x0, x1, pixel);
+            }
+
+            template <typename RowFunction>
+            void Canvas::forEachCircleRow(const unsigned int r, RowFunction&& row)
+            {
+                // A pixel is inside, if its center is inside the circle of radius r + 1/2
+                const long long limit = static_cast<long long>(r) * r + r;
+
+                int outer = static_cast<int>(r);
+
+                for (int relY = 0; relY <= static_cast<int>(r); ++relY)
+                {
+                    // The next row's half width, the part of this row beyond it is the outline
+                    int next = outer;
+
+                    if (relY == static_cast<int>(r)) next = -1;
+                    else while (next >= 0 && static_cast<long long>(next) * next + static_cast<long long>(relY + 1) * (relY + 1) > limit) --next;
+
+                    // At least one outline pixel on the steep sides
+                    row(relY, outer, next < outer ? next : outer - 1);
+
+                    outer = next;
+                }
+            }
+
+        //}
+        //----------------------------------------------------------------------------
+
+
+        //----------------------------------------------------------------------------
+        //{ Rendering
+        //----------------------------------------------------------------------------
+
+            //----------------------------------------------------------------------------
+            //{ Clearing
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::clearInsecure(const SDL_Color& color)
+                {
+                    // Whole rows without padding are contiguous, so every band is one span
+                    if (static_cast<size_t>(lockRect_.w) == pitch_)
+                    {
+                        Uint32 packed = PackColor(color);
+
+                        forEachBand
+                        (
+                            lockRect_.y, lockRect_.h, lockRect_.w,
+                            [this, packed] (int bandY, unsigned int bandH)
+                            {
+                                FillSpan(pixelAt(lockRect_.x, bandY), pitch_ * bandH, packed);
+                            }
+                        );
+
+                        return *this;
+                    }
+
+                    return fillRectInsecure(lockRect_.x, lockRect_.y, lockRect_.w, lockRect_.h, color);
+                }
+
+                Canvas& Canvas::clear(const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::clear(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    return clearInsecure(color);
+                }
+
+                Canvas& Canvas::clear()
+                {
+                    return clear(fillColor_);
+                }
+                
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Filled rectangle
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::fillRectInsecure(const int x, const int y, const unsigned int w, const unsigned int h, const SDL_Color& color)
+                {
+                    Uint32 packed = PackColor(color);
+
+                    forEachBand
+                    (
+                        y, h, w,
+                        [this, x, w, packed] (int bandY, unsigned int bandH)
+                        {
+                            Uint32* row = pixelAt(x, bandY);
+
+                            for (unsigned int curY = 0; curY < bandH; ++curY, row += pitch_)
+                            {
+                                FillSpan(row, w, packed);
+                            }
+                        }
+                    );
+
+                    return *this;
+                }
+
+                Canvas& Canvas::fillRect(int x, int y, unsigned int w, unsigned int h, const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::fillRect(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    if (!clipRect(x, y, w, h)) return *this;
+
+                    return fillRectInsecure(x, y, w, h, color);
+                }
+
+                Canvas& Canvas::fillRect(int x, int y, unsigned int w, unsigned int h)
+                {
+                    return fillRect(x, y, w, h, fillColor_);
+                }
+
+                Canvas& Canvas::fillRects(const SDL_Rect* rects, size_t count, const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::fillRects(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    Uint32 packed = PackColor(color);
+
+                    // Every band draws its part of every rectangle, so the order inside a band is kept
+                    forEachBand
+                    (
+                        lockRect_.y, lockRect_.h, lockRect_.w,
+                        [this, rects, count, packed] (int bandY, unsigned int bandH)
+                        {
+                            for (size_t i = 0; i < count; ++i)
+                            {
+                                int x = rects[i].x, y = rects[i].y;
+                                unsigned int w = rects[i].w > 0 ? rects[i].w : 0;
+                                unsigned int h = rects[i].h > 0 ? rects[i].h : 0;
+
+                                if (!clipRect(x, y, w, h)) continue;
+
+                                int fromY = y > bandY ? y : bandY;
+                                int toY   = y + static_cast<int>(h) < bandY + static_cast<int>(bandH) ? y + static_cast<int>(h) : bandY + static_cast<int>(bandH);
+
+                                for (int curY = fromY; curY < toY; ++curY)
+                                {
+                                    FillSpan(pixelAt(x, curY), w, packed);
+                                }
+                            }
+                        }
+                    );
+
+                    return *this;
+                }
+
+                Canvas& Canvas::fillRects(const SDL_Rect* rects, size_t count)
+                {
+                    return fillRects(rects, count, fillColor_);
+                }
+
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Rectangle
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::rectInsecure(const int x, const int y, const unsigned int w, const unsigned int h, const Uint32 pixel, const SDL_Rect& clip)
+                {
+                    int right  = x + static_cast<int>(w) - 1;
+                    int bottom = y + static_cast<int>(h) - 1;
+
+                    // Top and bottom are whole spans, the sides are one pixel spans
+                    spanClipped(clip, y, x, right, pixel);
+                    if (bottom != y) spanClipped(clip, bottom, x, right, pixel);
+
+                    for (int curY = std::max(y + 1, clip.y); curY < std::min(bottom, clip.y + clip.h); ++curY)
+                    {
+                        spanClipped(clip, curY, x, x, pixel);
+                        spanClipped(clip, curY, right, right, pixel);
+                    }
+
+                    return *this;
+                }
+
+                Canvas& Canvas::rect(int x, int y, unsigned int w, unsigned int h, const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::rect(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    if (w == 0 || h == 0) return *this;
+
+                    return rectInsecure(x, y, w, h, PackColor(color), lockRect_);
+                }
+
+                Canvas& Canvas::rect(int x, int y, unsigned int w, unsigned int h)
+                {
+                    return rect(x, y, w, h, lineColor_);
+                }
+
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Pixel
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::pixelInsecure(const int x, const int y, const SDL_Color& color)
+                {
+                    *pixelAt(x, y) = PackColor(color);
+
+                    return *this;
+                }
+
+                Canvas& Canvas::pixel(const int x, const int y, const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::pixel(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    if (lockRect_.x > x || x >= lockRect_.x + lockRect_.w)
+                    {
+                        return *this;
+                    }
+
+                    if (lockRect_.y > y || y >= lockRect_.y + lockRect_.h)
+                    {
+                        return *this;
+                    }
+                    
+                    return pixelInsecure(x, y, color);
+                }
+
+                Canvas& Canvas::pixel(const int x, const int y)
+                {
+                    return pixel(x, y, lineColor_);
+                }
+
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Pixel
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::lineInsecure(int x0, int y0, int x1, int y1, const Uint32 pixel, const SDL_Rect& clip)
+                {
+                    // Horizontal lines are just spans
+                    if (y0 == y1)
+                    {
+                        spanClipped(clip, y0, std::min(x0, x1), std::max(x0, x1), pixel);
+
+                        return *this;
+                    }
+
+                    bool swappedXandY = false;
+
+                    if (abs(y1 - y0) > abs(x1 - x0))
+                    {
+                        std::swap(y0, x0);
+                        std::swap(y1, x1);
+
+                        swappedXandY = true;
+                    }
+
+                    if (x1 < x0)
+                    {
+                        std::swap(x0, x1);
+                        std::swap(y0, y1);
+                    }
+
+                    int dX = x1 - x0;
+                    int dY = y1 - y0;
+                    int dX2 = dX << 1;
+
+                    int error2dX = 0;
+                    int deltaError = -(dY << 1);
+
+                    for (int x = x0, y = y0; x <= x1; x++, error2dX += deltaError)
+                    {
+                        // The whole line is walked whatever the clip is, so clipped parts match the unclipped line
+                        int curX = swappedXandY ? y : x;
+                        int curY = swappedXandY ? x : y;
+
+                        if (curX >= clip.x && curX < clip.x + clip.w && curY >= clip.y && curY < clip.y + clip.h)
+                        {
+                            *pixelAt(curX, curY) = pixel;
+                        }
+
+                        if (error2dX < -dX)
+                        {
+                            error2dX += dX2;
+                            y++;
+                        }
+                        else if (error2dX > dX)
+                        {
+                            error2dX -= dX2;
+                            y--;
+                        }
+                    }
+
+                    return *this;
+                }
+
+                Canvas& Canvas::line(int x0, int y0, int x1, int y1, const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::line(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    // Clipped to the texture, not to the locked rectangle, so a line has the same pixels whatever is locked
+                    SDL_Rect screen = {0, 0, static_cast<int>(destSizeX_ - 1), static_cast<int>(destSizeY_ - 1)};
+
+                    SDL_IntersectRectAndLine(&screen, &x0, &y0, &x1, &y1);
+
+                    if (x0 < 0 || x0 >= static_cast<int>(destSizeX_) || y0 < 0 || y0 >= static_cast<int>(destSizeY_)) return *this;
+
+                    return lineInsecure(x0, y0, x1, y1, PackColor(color), lockRect_);
+                }
+
+                Canvas& Canvas::line(int x0, int y0, int x1, int y1)
+                {
+                    return line(x0, y0, x1, y1, lineColor_);
+                }
+            
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Circle
+            //----------------------------------------------------------------------------
+
+                 Canvas& Canvas::circleInsecure(const int x, const int y, const unsigned int r, const Uint32 pixel, const SDL_Rect& clip)
+                 {
+                    forEachCircleRow
+                    (
+                        r,
+                        [this, x, y, pixel, &clip] (int relY, int outer, int inner)
+                        {
+                            // Two runs per row, the upper half mirrors the lower one
+                            for (int curY : {y + relY, y - relY})
+                            {
+                                spanClipped(clip, curY, x - outer, x - inner - 1, pixel);
+                                spanClipped(clip, curY, x + inner + 1, x + outer, pixel);
+
+                                if (relY == 0) break;
+                            }
+                        }
+                    );
+
+                    return *this;
+                 }
+
+                 Canvas& Canvas::circle(const int x, const int y, const unsigned int r, const SDL_Color& color)
+                 {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::circle(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    return circleInsecure(x, y, r, PackColor(color), lockRect_);
+                 }
+
+                 Canvas& Canvas::circle(const int x, const int y, const unsigned int r)
+                 {
+                    return circle(x, y, r, lineColor_);
+                 }
+            
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Round
+            //----------------------------------------------------------------------------
+
+                 Canvas& Canvas::roundInsecure(const int x, const int y, const unsigned int r, const Uint32 linePixel, const Uint32 fillPixel, const SDL_Rect& clip)
+                 {
+                    forEachCircleRow
+                    (
+                        r,
+                        [this, x, y, linePixel, fillPixel, &clip] (int relY, int outer, int inner)
+                        {
+                            for (int curY : {y + relY, y - relY})
+                            {
+                                spanClipped(clip, curY, x - outer, x - inner - 1, linePixel);
+                                spanClipped(clip, curY, x - inner, x + inner,     fillPixel);
+                                spanClipped(clip, curY, x + inner + 1, x + outer, linePixel);
+
+                                if (relY == 0) break;
+                            }
+                        }
+                    );
+
+                    return *this;
+                 }
+
+                 Canvas& Canvas::round(const int x, const int y, const unsigned int r, const SDL_Color& color, const SDL_Color& fillColor)
+                 {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::round(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    return roundInsecure(x, y, r, PackColor(color), PackColor(fillColor), lockRect_);
+                 }
+
+                 Canvas& Canvas::round(const int x, const int y, const unsigned int r)
+                 {
+                    return round(x, y, r, lineColor_, fillColor_);
+                 }
+
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Smooth line
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::smoothLineInsecure(int x0, int y0, int x1, int y1, const Uint32 pixel, const SDL_Rect& clip)
+                {
+                    // Walking along the major axis, the minor coordinate is 16.16 fixed point
+                    // (made by multiplying: it may be negative, and shifting those left is undefined)
+                    const bool steep = abs(y1 - y0) > abs(x1 - x0);
+
+                    if (steep)
+                    {
+                        std::swap(x0, y0);
+                        std::swap(x1, y1);
+                    }
+
+                    if (x1 < x0)
+                    {
+                        std::swap(x0, x1);
+                        std::swap(y0, y1);
+                    }
+
+                    const int dX = x1 - x0;
+                    const int dY = y1 - y0;
+
+                    const long long gradient = dX == 0 ? 0 : static_cast<long long>(dY) * 65536 / dX;
+
+                    // Only the part over the clip is walked; the minor coordinate there is the same as if it was walked from x0
+                    const int clipFrom = steep ? clip.y : clip.x;
+                    const int clipTo   = steep ? clip.y + clip.h - 1 : clip.x + clip.w - 1;
+
+                    const int from = std::max(x0, clipFrom);
+                    const int to   = std::min(x1, clipTo);
+
+                    if (from > to) return *this;
+
+                    long long minor = static_cast<long long>(y0) * 65536 + gradient * (from - x0);
+
+                    // Next pixel along the major and the minor axis
+                    const ptrdiff_t majorStep = steep ? static_cast<ptrdiff_t>(pitch_) : 1;
+                    const ptrdiff_t minorStep = steep ? 1 : static_cast<ptrdiff_t>(pitch_);
+
+                    const int minorFrom = steep ? clip.x : clip.y;
+                    const int minorTo   = steep ? clip.x + clip.w - 1 : clip.y + clip.h - 1;
+
+                    int       minorInt = static_cast<int>(minor >> 16);
+                    ptrdiff_t offset   = steep ? (from - lockRect_.y) * static_cast<ptrdiff_t>(pitch_) + (minorInt - lockRect_.x)
+                                               : (minorInt - lockRect_.y) * static_cast<ptrdiff_t>(pitch_) + (from - lockRect_.x);
+
+                    for (int major = from; major <= to; ++major, minor += gradient, offset += majorStep)
+                    {
+                        const int nextInt = static_cast<int>(minor >> 16);
+
+                        offset  += (nextInt - minorInt) * minorStep;
+                        minorInt = nextInt;
+
+                        // The pixel the line crosses and the one after it share the coverage
+                        const Uint32 coverage = static_cast<Uint32>(minor >> 8) & 0xFF;
+
+                        if (minorInt >= minorFrom && minorInt <= minorTo)
+                        {
+                            pixelBuffer_[offset] = BlendPixel(pixelBuffer_[offset], pixel, 256 - coverage);
+                        }
+
+                        if (coverage != 0 && minorInt + 1 >= minorFrom && minorInt + 1 <= minorTo)
+                        {
+                            pixelBuffer_[offset + minorStep] = BlendPixel(pixelBuffer_[offset + minorStep], pixel, coverage);
+                        }
+                    }
+
+                    return *this;
+                }
+
+                Canvas& Canvas::smoothLine(int x0, int y0, int x1, int y1, const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::smoothLine(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    return smoothLineInsecure(x0, y0, x1, y1, PackColor(color), lockRect_);
+                }
+
+                Canvas& Canvas::smoothLine(int x0, int y0, int x1, int y1)
+                {
+                    return smoothLine(x0, y0, x1, y1, lineColor_);
+                }
+
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Smooth circle
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::smoothCircleInsecure(const int x, const int y, const unsigned int r, const Uint32 pixel, const SDL_Rect& clip)
+                {
+                    const int       radius = static_cast<int>(r);
+                    const ptrdiff_t pitch  = static_cast<ptrdiff_t>(pitch_);
+
+                    // One octant, 0 <= relX <= whole, mirrored to the other seven. A mirror is (signX * u, signY * v)
+                    // from the center, (u, v) being (relX, whole) or, swapped, (whole, relX). Every mirror keeps the
+                    // offset of its pixel and steps it along with relX and whole, so no address is computed per pixel.
+                    struct Mirror
+                    {
+                        int       signX;
+                        int       signY;
+                        bool      swapped;
+                        ptrdiff_t stepX;     // When relX grows
+                        ptrdiff_t stepWhole; // When whole grows: outwards
+                        ptrdiff_t offset;
+                    };
+
+                    const ptrdiff_t center = (y - lockRect_.y) * pitch + (x - lockRect_.x);
+
+                    Mirror mirrors[8];
+
+                    for (int i = 0; i < 8; ++i)
+                    {
+                        Mirror& mirror = mirrors[i];
+
+                        mirror.signX     = (i & 1) ? -1 : 1;
+                        mirror.signY     = (i & 2) ? -1 : 1;
+                        mirror.swapped   = i >= 4;
+                        mirror.stepX     = mirror.swapped ? mirror.signY * pitch : mirror.signX;
+                        mirror.stepWhole = mirror.swapped ? mirror.signX : mirror.signY * pitch;
+                        mirror.offset    = center + radius * mirror.stepWhole;
+                    }
+
+                    // The clip is only checked per pixel if the circle isn't inside it
+                    const bool inside = x - radius - 1 >= clip.x && x + radius + 1 < clip.x + clip.w &&
+                                        y - radius - 1 >= clip.y && y + radius + 1 < clip.y + clip.h;
+
+                    // relY is whole or whole + 1 (outward), the same pixel is never blended twice
+                    auto plot = [this, x, y, pixel, inside, &clip, &mirrors] (int relX, int relY, ptrdiff_t outward, Uint32 coverage)
+                    {
+                        for (const Mirror& mirror : mirrors)
+                        {
+                            // On the diagonal both halves of the octant are the same pixels
+                            if (mirror.swapped && relX == relY) break;
+
+                            const int u = mirror.swapped ? relY : relX;
+                            const int v = mirror.swapped ? relX : relY;
+
+                            if ((mirror.signX < 0 && u == 0) || (mirror.signY < 0 && v == 0)) continue;
+
+                            if (!inside)
+                            {
+                                const int curX = x + mirror.signX * u;
+                                const int curY = y + mirror.signY * v;
+
+                                if (curX < clip.x || curX >= clip.x + clip.w || curY < clip.y || curY >= clip.y + clip.h) continue;
+                            }
+
+                            Uint32& dest = pixelBuffer_[mirror.offset + outward * mirror.stepWhole];
+
+                            dest = BlendPixel(dest, pixel, coverage);
+                        }
+                    };
+
+                    // relY in 8.8 fixed point: the largest value with relY^2 <= (r^2 - relX^2) * 2^16 = target.
+                    // Both only go down as relX grows: relY^2 and target are kept up to date instead of recomputed.
+                    long long relY   = static_cast<long long>(r) * 256;
+                    long long relY2  = relY * relY;
+                    long long target = relY2;
+                    int       whole  = radius;
+
+                    for (int relX = 0; relX <= whole; ++relX)
+                    {
+                        if (relY2 > target)
+                        {
+                            // (relY - d)^2 >= relY^2 - 2 * relY * d, so this d never steps past the answer
+                            const long long excess = relY2 - target;
+                            const long long down   = (excess + 2 * relY - 1) / (2 * relY);
+
+                            relY2 += down * down - 2 * down * relY;
+                            relY  -= down;
+
+                            while (relY2 > target)
+                            {
+                                relY2 -= 2 * relY - 1;
+                                --relY;
+                            }
+                        }
+
+                        const int    nextWhole = static_cast<int>(relY >> 8);
+                        const Uint32 fraction  = static_cast<Uint32>(relY & 0xFF);
+
+                        for (Mirror& mirror : mirrors) mirror.offset += (nextWhole - whole) * mirror.stepWhole;
+                        whole = nextWhole;
+
+                        if (relX > whole) break;
+
+                        plot(relX, whole, 0, 256 - fraction);
+
+                        if (fraction != 0) plot(relX, whole + 1, 1, fraction);
+
+                        for (Mirror& mirror : mirrors) mirror.offset += mirror.stepX;
+                        target -= (2 * static_cast<long long>(relX) + 1) * 65536;
+                    }
+
+                    return *this;
+                }
+
+                Canvas& Canvas::smoothCircle(const int x, const int y, const unsigned int r, const SDL_Color& color)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::smoothCircle(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    return smoothCircleInsecure(x, y, r, PackColor(color), lockRect_);
+                }
+
+                Canvas& Canvas::smoothCircle(const int x, const int y, const unsigned int r)
+                {
+                    return smoothCircle(x, y, r, lineColor_);
+                }
+
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Draw list
+            //----------------------------------------------------------------------------
+
+                Canvas& Canvas::commandInsecure(const DrawCommand& command, const SDL_Rect& clip)
+                {
+                    switch (command.type)
+                    {
+                        case DrawCommandType::Pixel:
+                        {
+                            spanClipped(clip, command.y, command.x, command.x, command.color);
+                            break;
+                        }
+                        case DrawCommandType::Line:
+                        {
+                            // Same endpoints as line() gets, so the same pixels
+                            int x0 = command.x, y0 = command.y, x1 = command.a, y1 = command.b;
+
+                            SDL_Rect screen = {0, 0, static_cast<int>(destSizeX_ - 1), static_cast<int>(destSizeY_ - 1)};
+
+                            SDL_IntersectRectAndLine(&screen, &x0, &y0, &x1, &y1);
+
+                            if (x0 < 0 || x0 >= static_cast<int>(destSizeX_) || y0 < 0 || y0 >= static_cast<int>(destSizeY_)) break;
+
+                            lineInsecure(x0, y0, x1, y1, command.color, clip);
+                            break;
+                        }
+                        case DrawCommandType::Rect:
+                        {
+                            rectInsecure(command.x, command.y, command.a, command.b, command.color, clip);
+                            break;
+                        }
+                        case DrawCommandType::FillRect:
+                        {
+                            // Not fillRectInsecure(): tiles may already run on the pool
+                            int fromY = std::max(command.y, clip.y);
+                            int toY   = std::min(command.y + command.b, clip.y + clip.h);
+
+                            for (int curY = fromY; curY < toY; ++curY)
+                            {
+                                spanClipped(clip, curY, command.x, command.x + command.a - 1, command.color);
+                            }
+                            break;
+                        }
+                        case DrawCommandType::Circle:
+                        {
+                            circleInsecure(command.x, command.y, command.a, command.color, clip);
+                            break;
+                        }
+                        case DrawCommandType::Round:
+                        {
+                            roundInsecure(command.x, command.y, command.a, command.color, command.fillColor, clip);
+                            break;
+                        }
+                        case DrawCommandType::SmoothLine:
+                        {
+                            smoothLineInsecure(command.x, command.y, command.a, command.b, command.color, clip);
+                            break;
+                        }
+                        case DrawCommandType::SmoothCircle:
+                        {
+                            smoothCircleInsecure(command.x, command.y, command.a, command.color, clip);
+                            break;
+                        }
+                    }
+
+                    return *this;
+                }
+
+                Canvas& Canvas::draw(DrawList& list, const SDL_Rect* regions /*= nullptr*/, size_t regionCount /*= 0*/)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::draw(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    list.sortByTile(destSizeX_, destSizeY_);
+
+                    const std::vector<DrawTile>&    tiles    = list.getTiles();
+                    const std::vector<Uint32>&      entries  = list.getTileEntries();
+                    const std::vector<DrawCommand>& commands = list.getCommands();
+
+                    auto drawTile = [&] (size_t index)
+                    {
+                        const DrawTile& tile = tiles[index];
+
+                        if (regions != nullptr)
+                        {
+                            bool touched = false;
+
+                            for (size_t i = 0; i < regionCount && !touched; ++i)
+                            {
+                                touched = SDL_HasIntersection(&tile.rect, &regions[i]) == SDL_TRUE;
+                            }
+
+                            if (!touched) return;
+                        }
+
+                        SDL_Rect clip = {};
+
+                        if (SDL_IntersectRect(&tile.rect, &lockRect_, &clip) != SDL_TRUE) return;
+
+                        for (size_t i = tile.begin; i < tile.end; ++i)
+                        {
+                            commandInsecure(commands[entries[i]], clip);
+                        }
+                    };
+
+                    // Tiles don't overlap, so they can be drawn in any order
+                    if (pool_ != nullptr && tiles.size() > 1) pool_->parallelFor(tiles.size(), drawTile);
+                    else for (size_t index = 0; index < tiles.size(); ++index) drawTile(index);
+
+                    return *this;
+                }
+
+            //}
+            //----------------------------------------------------------------------------
+
+
+            //----------------------------------------------------------------------------
+            //{ Apply function on a rectangle
+            //----------------------------------------------------------------------------
+
+                template <typename RowShader>
+                Canvas& Canvas::applyRowShaderInsecure(const int x, const int y, const unsigned int w, const unsigned int h, RowShader& shader)
+                {
+                    forEachBand
+                    (
+                        y, h, w,
+                        [this, x, w, &shader] (int bandY, unsigned int bandH)
+                        {
+                            Uint32* row = pixelAt(x, bandY);
+
+                            for (int curY = bandY; curY < bandY + static_cast<int>(bandH); ++curY, row += pitch_)
+                            {
+                                shader(x, curY, row, w);
+                            }
+                        }
+                    );
+
+                    return *this;
+                }
+
+                template <typename RowShader>
+                Canvas& Canvas::applyRowShader(int x, int y, unsigned int w, unsigned int h, RowShader&& shader)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::applyRowShader(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    if (!clipRect(x, y, w, h)) return *this;
+
+                    return applyRowShaderInsecure(x, y, w, h, shader);
+                }
+
+                template <typename Shader>
+                Canvas& Canvas::applyShader(int x, int y, unsigned int w, unsigned int h, Shader&& shader)
+                {
+                    if (pixelBuffer_ == nullptr)
+                    {
+                        throw std::string("Canvas::applyShader(): rendering has not been started yet (no pixels to draw on)"); 
+                    }
+
+                    if (!clipRect(x, y, w, h)) return *this;
+
+                    // Per-pixel shader on top of the row form, no indirect call per pixel
+                    auto rowShader = [&shader] (int rowX, int rowY, Uint32* pixels, unsigned int count)
+                    {
+                        for (unsigned int i = 0; i < count; ++i)
+                        {
+                            pixels[i] = PackColor(shader(rowX + static_cast<int>(i), rowY, UnpackColor(pixels[i])));
+                        }
+                    };
+
+                    return applyRowShaderInsecure(x, y, w, h, rowShader);
+                }
+            
+            //}
+            //----------------------------------------------------------------------------
+
+        //----------------------------------------------------------------------------
+        //{ Blit
+        //----------------------------------------------------------------------------
+
+            Canvas& Canvas::blit(const Uint32* pixels, size_t pitch, unsigned int w, unsigned int h, int x, int y)
+            {
+                if (pixelBuffer_ == nullptr)
+                {
+                    throw std::string("Canvas::blit(): rendering has not been started yet (no pixels to draw on)"); 
+                }
+
+                int toX = x, toY = y;
+
+                if (!clipRect(toX, toY, w, h)) return *this;
+
+                const Uint32* source = pixels + pitch * (toY - y) + (toX - x);
+
+                for (unsigned int curY = 0; curY < h; ++curY, source += pitch)
+                {
+                    std::memcpy(pixelAt(toX, toY + static_cast<int>(curY)), source, w * sizeof(Uint32));
+                }
+
+                return *this;
+            }
+
+        //}
+        //----------------------------------------------------------------------------
+
+    //}
+    //----------------------------------------------------------------------------
+
+//}
+//----------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------
+//{ Bitmap
+//----------------------------------------------------------------------------
+
+    // A canvas over its own memory, always bound
+    class Bitmap : public Canvas
+    {
+        public:
+
+            // Constructor:
+
+                Bitmap(unsigned int sizeX, unsigned int sizeY);
+
+            // Getters:
+
+                const Uint32* getPixels() const;
+                const Uint32* getPixels(int x, int y) const;
+
+                size_t getPitch() const;
+
+        private:
+
+            // Variables:
+
+                std::vector<Uint32> pixels_;
+    };
+
+
+    //----------------------------------------------------------------------------
+    //{ Constructor
+    //----------------------------------------------------------------------------
+
+        Bitmap::Bitmap(unsigned int sizeX, unsigned int sizeY) :
+            Canvas  (sizeX, sizeY),
+            pixels_ (static_cast<size_t>(sizeX) * sizeY)
+        {
+            bind(pixels_.data(), sizeX, {0, 0, static_cast<int>(sizeX), static_cast<int>(sizeY)});
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Getters
+    //----------------------------------------------------------------------------
+
+        const Uint32* Bitmap::getPixels() const
+        {
+            return pixels_.data();
+        }
+
+        const Uint32* Bitmap::getPixels(int x, int y) const
+        {
+            return pixels_.data() + getPitch() * y + x;
+        }
+
+        size_t Bitmap::getPitch() const
+        {
+            return getDestSizeX();
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+//}
+//----------------------------------------------------------------------------
+
+}
+
+#endif /*MY_SDL_CANVAS_HPP_INCLUDED*/
\ No newline at end of file
@@ -0,0 +1,365 @@
+#ifndef MY_SDL_DRAW_LIST_HPP_INCLUDED
+#define MY_SDL_DRAW_LIST_HPP_INCLUDED
+
+//----------------------------------------------------------------------------
+//{ Includes
+//----------------------------------------------------------------------------
+
+    #include <algorithm>
+    #include <cstdlib>
+    #include <stdexcept>
+    #include <vector>
+
+    #include <SDL2/SDL.h>
+
+    #include "MySDL_Pixels.hpp"
+
+//}
+//----------------------------------------------------------------------------
+
+
+namespace MySDL
+{
+
+//----------------------------------------------------------------------------
+//{ Draw commands
+//----------------------------------------------------------------------------
+
+    enum class DrawCommandType : Uint8
+    {
+        Pixel,
+        Line,
+        Rect,
+        FillRect,
+        Circle,
+        Round,
+        SmoothLine,
+        SmoothCircle
+    };
+
+    // Plain data, so a list is one contiguous array.
+    // Pixel: (x, y); Line, SmoothLine: (x, y) - (a, b); Rect, FillRect: (x, y, w = a, h = b); Circle, Round, SmoothCircle: (x, y, r = a)
+    struct DrawCommand
+    {
+        DrawCommandType type;
+
+        int x;
+        int y;
+        int a;
+        int b;
+
+        Uint32 color;
+        Uint32 fillColor;
+
+        // Every pixel the command can touch
+        SDL_Rect bounds;
+    };
+
+    // A tile and the commands touching it, [begin, end) in DrawList::getTileEntries()
+    struct DrawTile
+    {
+        SDL_Rect rect;
+
+        size_t begin;
+        size_t end;
+    };
+
+//}
+//----------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------
+//{ DrawList
+//----------------------------------------------------------------------------
+
+    // Retained primitives: recorded once, binned by tile, drawn by Renderer::draw() as many times as needed.
+    // Inside a tile commands keep the recording order, so the picture is the same as drawing them one by one.
+    class DrawList
+    {
+        public:
+
+            // Constructor:
+
+                explicit DrawList(unsigned int tileSide = 64);
+
+            // Getters:
+
+                unsigned int getTileSide() const;
+
+                size_t size() const;
+
+                const std::vector<DrawCommand>& getCommands() const;
+
+                // Valid after sortByTile()
+                const std::vector<DrawTile>& getTiles()       const;
+                const std::vector<Uint32>&   getTileEntries() const;
+
+            // Functions:
+
+                // Recording:
+
+                    DrawList& clear();
+
+                    DrawList& pixel   (int x,  int y,                                   const SDL_Color& color);
+                    DrawList& line    (int x0, int y0, int x1, int y1,                  const SDL_Color& color);
+                    DrawList& rect    (int x,  int y,  unsigned int w, unsigned int h,  const SDL_Color& color);
+                    DrawList& fillRect(int x,  int y,  unsigned int w, unsigned int h,  const SDL_Color& color);
+                    DrawList& circle  (int x,  int y,  unsigned int r,                  const SDL_Color& color);
+                    DrawList& round   (int x,  int y,  unsigned int r,                  const SDL_Color& lineColor, const SDL_Color& fillColor);
+
+                    // Anti-aliased, see Canvas::smoothLine()
+                    DrawList& smoothLine  (int x0, int y0, int x1, int y1, const SDL_Color& color);
+                    DrawList& smoothCircle(int x,  int y,  unsigned int r, const SDL_Color& color);
+
+                // Binning:
+
+                    // Bins the commands into tiles of a sizeX * sizeY target; does nothing, if nothing has changed since the last call
+                    DrawList& sortByTile(unsigned int sizeX, unsigned int sizeY);
+
+        private:
+
+            struct TileEntry
+            {
+                Uint32 tile;
+                Uint32 command;
+
+                bool operator<(const TileEntry& that) const
+                {
+                    return tile != that.tile ? tile < that.tile : command < that.command;
+                }
+            };
+
+            // Variables:
+
+                unsigned int tileSide_;
+
+                std::vector<DrawCommand> commands_;
+
+                std::vector<TileEntry> entries_;
+                std::vector<Uint32>    tileEntries_;
+                std::vector<DrawTile>  tiles_;
+
+                bool         sorted_;
+                unsigned int sortedSizeX_;
+                unsigned int sortedSizeY_;
+
+            // Functions, that should not appear anywhere outside:
+
+                DrawList& record(DrawCommandType type, int x, int y, int a, int b, Uint32 color, Uint32 fillColor, const SDL_Rect& bounds);
+    };
+
+
+    //----------------------------------------------------------------------------
+    //{ Constructor
+    //----------------------------------------------------------------------------
+
+        DrawList::DrawList(unsigned int tileSide /*= 64*/) :
+            tileSide_    (tileSide),
+            commands_    (),
+            entries_     (),
+            tileEntries_ (),
+            tiles_       (),
+            sorted_      (false),
+            sortedSizeX_ (0),
+            sortedSizeY_ (0)
+        {
+            if (tileSide_ == 0)
+            {
+                throw std::invalid_argument("DrawList::constructor: tile side is 0\n");
+            }
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Getters
+    //----------------------------------------------------------------------------
+
+        unsigned int DrawList::getTileSide() const
+        {
+            return tileSide_;
+        }
+
+        size_t DrawList::size() const
+        {
+            return commands_.size();
+        }
+
+        const std::vector<DrawCommand>& DrawList::getCommands() const
+        {
+            return commands_;
+        }
+
+        const std::vector<DrawTile>& DrawList::getTiles() const
+        {
+            return tiles_;
+        }
+
+        const std::vector<Uint32>& DrawList::getTileEntries() const
+        {
+            return tileEntries_;
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Recording
+    //----------------------------------------------------------------------------
+
+        DrawList& DrawList::record(DrawCommandType type, int x, int y, int a, int b, Uint32 color, Uint32 fillColor, const SDL_Rect& bounds)
+        {
+            commands_.push_back({type, x, y, a, b, color, fillColor, bounds});
+
+            sorted_ = false;
+
+            return *this;
+        }
+
+        DrawList& DrawList::clear()
+        {
+            commands_.clear();
+
+            sorted_ = false;
+
+            return *this;
+        }
+
+        DrawList& DrawList::pixel(int x, int y, const SDL_Color& color)
+        {
+            return record(DrawCommandType::Pixel, x, y, 0, 0, PackColor(color), 0, {x, y, 1, 1});
+        }
+
+        DrawList& DrawList::line(int x0, int y0, int x1, int y1, const SDL_Color& color)
+        {
+            SDL_Rect bounds = {std::min(x0, x1), std::min(y0, y1), std::abs(x1 - x0) + 1, std::abs(y1 - y0) + 1};
+
+            return record(DrawCommandType::Line, x0, y0, x1, y1, PackColor(color), 0, bounds);
+        }
+
+        DrawList& DrawList::rect(int x, int y, unsigned int w, unsigned int h, const SDL_Color& color)
+        {
+            if (w == 0 || h == 0) return *this;
+
+            return record(DrawCommandType::Rect, x, y, w, h, PackColor(color), 0, {x, y, static_cast<int>(w), static_cast<int>(h)});
+        }
+
+        DrawList& DrawList::fillRect(int x, int y, unsigned int w, unsigned int h, const SDL_Color& color)
+        {
+            if (w == 0 || h == 0) return *this;
+
+            return record(DrawCommandType::FillRect, x, y, w, h, PackColor(color), 0, {x, y, static_cast<int>(w), static_cast<int>(h)});
+        }
+
+        DrawList& DrawList::circle(int x, int y, unsigned int r, const SDL_Color& color)
+        {
+            int side = 2 * static_cast<int>(r) + 1;
+
+            return record(DrawCommandType::Circle, x, y, r, 0, PackColor(color), 0, {x - static_cast<int>(r), y - static_cast<int>(r), side, side});
+        }
+
+        DrawList& DrawList::round(int x, int y, unsigned int r, const SDL_Color& lineColor, const SDL_Color& fillColor)
+        {
+            int side = 2 * static_cast<int>(r) + 1;
+
+            return record(DrawCommandType::Round, x, y, r, 0, PackColor(lineColor), PackColor(fillColor), {x - static_cast<int>(r), y - static_cast<int>(r), side, side});
+        }
+
+        DrawList& DrawList::smoothLine(int x0, int y0, int x1, int y1, const SDL_Color& color)
+        {
+            // Coverage spills over to the neighbours across the line
+            SDL_Rect bounds = {std::min(x0, x1) - 1, std::min(y0, y1) - 1, std::abs(x1 - x0) + 3, std::abs(y1 - y0) + 3};
+
+            return record(DrawCommandType::SmoothLine, x0, y0, x1, y1, PackColor(color), 0, bounds);
+        }
+
+        DrawList& DrawList::smoothCircle(int x, int y, unsigned int r, const SDL_Color& color)
+        {
+            int side = 2 * static_cast<int>(r) + 3;
+
+            return record(DrawCommandType::SmoothCircle, x, y, r, 0, PackColor(color), 0, {x - static_cast<int>(r) - 1, y - static_cast<int>(r) - 1, side, side});
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Binning
+    //----------------------------------------------------------------------------
+
+        DrawList& DrawList::sortByTile(unsigned int sizeX, unsigned int sizeY)
+        {
+            if (sorted_ && sortedSizeX_ == sizeX && sortedSizeY_ == sizeY) return *this;
+
+            const int tilesX = static_cast<int>((sizeX + tileSide_ - 1) / tileSide_);
+            const int tilesY = static_cast<int>((sizeY + tileSide_ - 1) / tileSide_);
+            const int side   = static_cast<int>(tileSide_);
+
+            entries_.clear();
+
+            for (size_t i = 0; i < commands_.size(); ++i)
+            {
+                const SDL_Rect& bounds = commands_[i].bounds;
+
+                // Off-target parts are dropped here, commands that are off the target entirely get no entries
+                if (bounds.x + bounds.w <= 0 || bounds.y + bounds.h <= 0) continue;
+
+                int fromX = std::max(bounds.x, 0) / side;
+                int fromY = std::max(bounds.y, 0) / side;
+                int toX   = std::min((bounds.x + bounds.w - 1) / side, tilesX - 1);
+                int toY   = std::min((bounds.y + bounds.h - 1) / side, tilesY - 1);
+
+                for (int tileY = fromY; tileY <= toY; ++tileY)
+                {
+                    for (int tileX = fromX; tileX <= toX; ++tileX)
+                    {
+                        entries_.push_back({static_cast<Uint32>(tileY * tilesX + tileX), static_cast<Uint32>(i)});
+                    }
+                }
+            }
+
+            // By tile, then by recording order
+            std::sort(entries_.begin(), entries_.end());
+
+            tileEntries_.resize(entries_.size());
+            tiles_.clear();
+
+            for (size_t i = 0; i < entries_.size(); ++i)
+            {
+                tileEntries_[i] = entries_[i].command;
+
+                if (tiles_.empty() || entries_[i].tile != entries_[i - 1].tile)
+                {
+                    int tileX = static_cast<int>(entries_[i].tile) % tilesX;
+                    int tileY = static_cast<int>(entries_[i].tile) / tilesX;
+
+                    SDL_Rect rect = {tileX * side, tileY * side, side, side};
+                    if (rect.x + rect.w > static_cast<int>(sizeX)) rect.w = static_cast<int>(sizeX) - rect.x;
+                    if (rect.y + rect.h > static_cast<int>(sizeY)) rect.h = static_cast<int>(sizeY) - rect.y;
+
+                    tiles_.push_back({rect, i, i});
+                }
+
+                tiles_.back().end = i + 1;
+            }
+
+            sorted_      = true;
+            sortedSizeX_ = sizeX;
+            sortedSizeY_ = sizeY;
+
+            return *this;
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+//}
+//----------------------------------------------------------------------------
+
+}
+
+#endif /*MY_SDL_DRAW_LIST_HPP_INCLUDED*/
\ No newline at end of file
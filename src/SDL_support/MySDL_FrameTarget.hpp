@@ -0,0 +1,67 @@
+#ifndef MY_SDL_FRAME_TARGET_HPP_INCLUDED
+#define MY_SDL_FRAME_TARGET_HPP_INCLUDED
+
+//----------------------------------------------------------------------------
+//{ Includes
+//----------------------------------------------------------------------------
+
+    #include <SDL2/SDL.h>
+
+    #include "MySDL_Canvas.hpp"
+
+//}
+//----------------------------------------------------------------------------
+
+
+namespace MySDL
+{
+
+//----------------------------------------------------------------------------
+//{ FrameTarget
+//----------------------------------------------------------------------------
+
+    // A canvas that shows frames somewhere: a window (Renderer) or a file (OffscreenRenderer)
+    class FrameTarget : public Canvas
+    {
+        public:
+
+            // Constructor:
+
+                FrameTarget(unsigned int sizeX, unsigned int sizeY) :
+                    Canvas (sizeX, sizeY)
+                {}
+
+            // Functions:
+
+                // Binds the pixels of the rectangle for drawing; the rest keeps its contents,
+                // the rectangle itself has to be redrawn completely
+                virtual FrameTarget& startRendering(const SDL_Rect& rect) = 0;
+
+                virtual FrameTarget& finishRendering() = 0;
+
+                // Reallocates the pixels for a new size; does nothing and returns false, if the size is the same.
+                // The picture is undefined after a reallocation, it has to be redrawn.
+                virtual bool resize(unsigned int sizeX, unsigned int sizeY) = 0;
+
+                // Puts the srcs parts of the picture to dests in the frame and shows it
+                virtual void present(const SDL_Rect* srcs, const SDL_Rect* dests, size_t count) = 0;
+
+                FrameTarget& startRendering()
+                {
+                    return startRendering({0, 0, static_cast<int>(getDestSizeX()), static_cast<int>(getDestSizeY())});
+                }
+
+                void present()
+                {
+                    SDL_Rect whole = {0, 0, static_cast<int>(getDestSizeX()), static_cast<int>(getDestSizeY())};
+
+                    present(&whole, &whole, 1);
+                }
+    };
+
+//}
+//----------------------------------------------------------------------------
+
+}
+
+#endif /*MY_SDL_FRAME_TARGET_HPP_INCLUDED*/
\ No newline at end of file
@@ -0,0 +1,327 @@
+#ifndef MY_SDL_OFFSCREEN_HPP_INCLUDED
+#define MY_SDL_OFFSCREEN_HPP_INCLUDED
+
+//----------------------------------------------------------------------------
+//{ Includes
+//----------------------------------------------------------------------------
+
+    #include <cerrno>
+    #include <cstdio>
+    #include <cstring>
+    #include <string>
+    #include <vector>
+
+    #include <SDL2/SDL.h>
+
+    #include "MySDL_FrameTarget.hpp"
+
+    #include "../trace/Trace.hpp"
+
+//}
+//----------------------------------------------------------------------------
+
+
+namespace MySDL
+{
+
+//----------------------------------------------------------------------------
+//{ FrameWriter
+//----------------------------------------------------------------------------
+
+    enum class FrameFormat
+    {
+        Ppm, // Binary PPM (P6) frames one after another, what "ffmpeg -f image2pipe" reads
+        Raw  // Bare R, G, B, A bytes, "ffmpeg -f rawvideo -pixel_format rgba"
+    };
+
+    // Streams frames to a file, a named pipe or (with path "-") to stdout
+    class FrameWriter
+    {
+        public:
+
+            // Constructor && destructor:
+
+                FrameWriter(const std::string& path, FrameFormat format);
+
+                ~FrameWriter();
+
+            // Getters:
+
+                size_t getFrameCount() const;
+
+            // Functions:
+
+                // pitch is in pixels
+                void write(const Uint32* pixels, size_t pitch, unsigned int w, unsigned int h);
+
+                void flush();
+
+        private:
+
+            // Variables:
+
+                FILE*       file_;
+                bool        ownsFile_;
+                FrameFormat format_;
+
+                std::vector<Uint8> row_;
+
+                size_t frameCount_;
+
+            // Functions, that shouldn't appear anywhere at all:
+
+                FrameWriter();
+
+                FrameWriter(const FrameWriter& writer);
+
+                FrameWriter& operator=(const FrameWriter& writer);
+    };
+
+
+    //----------------------------------------------------------------------------
+    //{ Constructor && destructor
+    //----------------------------------------------------------------------------
+
+        FrameWriter::FrameWriter(const std::string& path, FrameFormat format) :
+            file_       (nullptr),
+            ownsFile_   (path != "-"),
+            format_     (format),
+            row_        (),
+            frameCount_ (0)
+        {
+            file_ = ownsFile_ ? std::fopen(path.c_str(), "wb") : stdout;
+
+            if (file_ == nullptr)
+            {
+                throw std::string("FrameWriter::constructor: can't open ") + path + ": " + std::strerror(errno);
+            }
+        }
+
+        FrameWriter::~FrameWriter()
+        {
+            if (ownsFile_) std::fclose(file_);
+            else           std::fflush(file_);
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Getters && functions
+    //----------------------------------------------------------------------------
+
+        size_t FrameWriter::getFrameCount() const
+        {
+            return frameCount_;
+        }
+
+        void FrameWriter::write(const Uint32* pixels, size_t pitch, unsigned int w, unsigned int h)
+        {
+            MORSE_TRACE_SCOPE("FrameWriter::write");
+
+            const size_t channels = format_ == FrameFormat::Ppm ? 3 : 4;
+
+            if (format_ == FrameFormat::Ppm) std::fprintf(file_, "P6\n%u %u\n255\n", w, h);
+
+            row_.resize(w * channels);
+
+            for (unsigned int y = 0; y < h; ++y, pixels += pitch)
+            {
+                Uint8* out = row_.data();
+
+                // Byte order of the file, whatever the byte order of the machine
+                for (unsigned int x = 0; x < w; ++x)
+                {
+                    *out++ = static_cast<Uint8>(pixels[x] >> 24);
+                    *out++ = static_cast<Uint8>(pixels[x] >> 16);
+                    *out++ = static_cast<Uint8>(pixels[x] >>  8);
+
+                    if (channels == 4) *out++ = static_cast<Uint8>(pixels[x]);
+                }
+
+                if (std::fwrite(row_.data(), 1, row_.size(), file_) != row_.size())
+                {
+                    throw std::string("FrameWriter::write(): fwrite failed: ") + std::strerror(errno);
+                }
+            }
+
+            ++frameCount_;
+        }
+
+        void FrameWriter::flush()
+        {
+            std::fflush(file_);
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+//}
+//----------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------
+//{ OffscreenRenderer
+//----------------------------------------------------------------------------
+
+    // Renderer without a window: draws into memory, present() hands the frame to a FrameWriter (if any).
+    // Nothing waits for a display, frames come out as fast as they are drawn.
+    class OffscreenRenderer : public FrameTarget
+    {
+        public:
+
+            // Constructor:
+
+                OffscreenRenderer(unsigned int sizeX, unsigned int sizeY, FrameWriter* writer = nullptr);
+
+            // Getters && setters:
+
+                // The last presented frame
+                const Uint32* getFrame() const;
+
+                OffscreenRenderer& setFrameWriter(FrameWriter* writer);
+
+            // Functions:
+
+                OffscreenRenderer&  startRendering(const SDL_Rect& rect) override;
+                OffscreenRenderer& finishRendering() override;
+
+                bool resize(unsigned int sizeX, unsigned int sizeY) override;
+
+                void present(const SDL_Rect* srcs, const SDL_Rect* dests, size_t count) override;
+
+                using FrameTarget::startRendering;
+                using FrameTarget::present;
+
+        private:
+
+            // Variables:
+
+                std::vector<Uint32> picture_; // What is drawn
+                std::vector<Uint32> frame_;   // What is shown
+
+                FrameWriter* writer_;
+    };
+
+
+    //----------------------------------------------------------------------------
+    //{ Constructor
+    //----------------------------------------------------------------------------
+
+        OffscreenRenderer::OffscreenRenderer(unsigned int sizeX, unsigned int sizeY, FrameWriter* writer /*= nullptr*/) :
+            FrameTarget (sizeX, sizeY),
+            picture_    (static_cast<size_t>(sizeX) * sizeY),
+            frame_      (static_cast<size_t>(sizeX) * sizeY),
+            writer_     (writer)
+        {}
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Getters && setters
+    //----------------------------------------------------------------------------
+
+        const Uint32* OffscreenRenderer::getFrame() const
+        {
+            return frame_.data();
+        }
+
+        OffscreenRenderer& OffscreenRenderer::setFrameWriter(FrameWriter* writer)
+        {
+            writer_ = writer;
+
+            return *this;
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Functions
+    //----------------------------------------------------------------------------
+
+        OffscreenRenderer& OffscreenRenderer::startRendering(const SDL_Rect& rect)
+        {
+            if (isBound())
+            {
+                throw std::string("OffscreenRenderer::startRendering(): rendering is already in process");
+            }
+
+            SDL_Rect whole = {0, 0, static_cast<int>(getDestSizeX()), static_cast<int>(getDestSizeY())}, bound = {};
+
+            if (SDL_IntersectRect(&rect, &whole, &bound) != SDL_TRUE)
+            {
+                throw std::string("OffscreenRenderer::startRendering(): the rectangle is outside the picture");
+            }
+
+            bind(picture_.data() + getDestSizeX() * bound.y + bound.x, getDestSizeX(), bound);
+
+            return *this;
+        }
+
+        OffscreenRenderer& OffscreenRenderer::finishRendering()
+        {
+            if (!isBound())
+            {
+                throw std::string("OffscreenRenderer::finishRendering(): rendering has not been started yet");
+            }
+
+            unbind();
+
+            return *this;
+        }
+
+        bool OffscreenRenderer::resize(unsigned int sizeX, unsigned int sizeY)
+        {
+            if (isBound())
+            {
+                throw std::string("OffscreenRenderer::resize(): rendering is not finished");
+            }
+
+            if (sizeX == getDestSizeX() && sizeY == getDestSizeY()) return false;
+
+            setSize(sizeX, sizeY);
+
+            picture_.assign(static_cast<size_t>(sizeX) * sizeY, 0);
+            frame_  .assign(static_cast<size_t>(sizeX) * sizeY, 0);
+
+            return true;
+        }
+
+        void OffscreenRenderer::present(const SDL_Rect* srcs, const SDL_Rect* dests, size_t count)
+        {
+            if (isBound())
+            {
+                throw std::string("OffscreenRenderer::present(): rendering is not finished");
+            }
+
+            MORSE_TRACE_SCOPE("OffscreenRenderer::present");
+
+            const size_t pitch = getDestSizeX();
+
+            // Plain copies: parts are expected to be of the same size and inside the picture, as SDL_RenderCopy without scaling
+            for (size_t i = 0; i < count; ++i)
+            {
+                for (int y = 0; y < srcs[i].h; ++y)
+                {
+                    std::memcpy(frame_.data()   + pitch * (dests[i].y + y) + dests[i].x,
+                                picture_.data() + pitch * (srcs [i].y + y) + srcs [i].x, srcs[i].w * sizeof(Uint32));
+                }
+            }
+
+            if (writer_ != nullptr) writer_->write(frame_.data(), pitch, getDestSizeX(), getDestSizeY());
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+//}
+//----------------------------------------------------------------------------
+
+}
+
+#endif /*MY_SDL_OFFSCREEN_HPP_INCLUDED*/
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef MY_SDL_PIXELS_HPP_INCLUDED
+#define MY_SDL_PIXELS_HPP_INCLUDED
+
+//----------------------------------------------------------------------------
+//{ Includes
+//----------------------------------------------------------------------------
+
+    #include <algorithm>
+
+    #include <SDL2/SDL.h>
+
+//}
+//----------------------------------------------------------------------------
+
+
+namespace MySDL
+{
+
+//----------------------------------------------------------------------------
+//{ Packed pixels
+//----------------------------------------------------------------------------
+
+    // SDL_PIXELFORMAT_RGBA8888 is a packed format: one native-endian Uint32 per pixel, R in the top byte.
+
+    inline Uint32 PackColor(const SDL_Color& color)
+    {
+        return (static_cast<Uint32>(color.r) << 24) |
+               (static_cast<Uint32>(color.g) << 16) |
+               (static_cast<Uint32>(color.b) <<  8) |
+               (static_cast<Uint32>(color.a) <<  0);
+    }
+
+    inline SDL_Color UnpackColor(Uint32 pixel)
+    {
+        return
+        {
+            static_cast<Uint8>(pixel >> 24),
+            static_cast<Uint8>(pixel >> 16),
+            static_cast<Uint8>(pixel >>  8),
+            static_cast<Uint8>(pixel >>  0)
+        };
+    }
+
+    // Whole 32-bit stores, the compiler turns this into vector stores
+    inline void FillSpan(Uint32* dest, size_t count, Uint32 pixel)
+    {
+        std::fill_n(dest, count, pixel);
+    }
+
+    // dest * (1 - coverage) + src * coverage on all four channels, coverage in [0, 256].
+    // Two channels per multiply: R and B, then G and A, each in a 16-bit lane that can't overflow.
+    inline Uint32 BlendPixel(Uint32 dest, Uint32 src, Uint32 coverage)
+    {
+        const Uint32 keep = 256 - coverage;
+
+        Uint32 rb = (((src      & 0x00FF00FF) * coverage + (dest      & 0x00FF00FF) * keep) >> 8) & 0x00FF00FF;
+        Uint32 ga = (((src >> 8 & 0x00FF00FF) * coverage + (dest >> 8 & 0x00FF00FF) * keep) >> 8) & 0x00FF00FF;
+
+        return rb | (ga << 8);
+    }
+
+//}
+//----------------------------------------------------------------------------
+
+}
+
+#endif /*MY_SDL_PIXELS_HPP_INCLUDED*/
\ No newline at end of file
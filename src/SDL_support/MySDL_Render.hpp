@@ -8,11 +8,17 @@
     #include <iostream>
     #include <iomanip>
     #include <functional>
+    #include <algorithm>
     #include <cstdlib>
     #include <random>
+    #include <vector>
     
     #include <SDL2/SDL.h>
 
+    #include "MySDL_FrameTarget.hpp"
+
+    #include "../trace/Trace.hpp"
+
 //}
 //----------------------------------------------------------------------------
 
@@ -24,79 +30,67 @@ namespace MySDL
 //{ Renderer
 //----------------------------------------------------------------------------
 
-    class Renderer
+    // A canvas shown in a window. Drawing goes to a back buffer in ordinary (cached) memory; flash() uploads
+    // the regions changed since the last upload into one of two streaming textures, taking turns, and shows it.
+    // The CPU never reads GPU-mapped memory, and an upload never waits for the texture the GPU is still drawing.
+    class Renderer : public FrameTarget
     {
         public:
 
             // Constructor && destructor:
 
-                Renderer(SDL_Window* window);
+                // flags are SDL_RendererFlags, SDL_RENDERER_PRESENTVSYNC makes flash() wait for the display refresh
+                Renderer(SDL_Window* window, Uint32 flags = SDL_RENDERER_ACCELERATED);
 
                 ~Renderer();
 
-            // Getters && setters:
-
-                size_t getDestSizeX() const;
-                size_t getDestSizeY() const;
-
             // Functions:
 
                 // Debugging:
 
-                    void dump() const;
+                    void dump() const override;
 
                 // Additional:
 
-                    void flash(const SDL_Rect* src = nullptr, const SDL_Rect* dest = nullptr) const;
-
-                    Renderer&  startRendering();
-                    Renderer& finishRendering();
-
-                // Colors:
-
-                    Renderer& setLineColor(const SDL_Color& lineColor);
-                    Renderer& setFillColor(const SDL_Color& fillColor);
+                    void flash(const SDL_Rect* src = nullptr, const SDL_Rect* dest = nullptr);
 
-                // Rendering:
+                    // Copies several parts of the picture to the window, then presents (e.g. a scrolled ring of rows)
+                    void flash(const SDL_Rect* srcs, const SDL_Rect* dests, size_t count);
 
-                    Renderer& clear(const SDL_Color& color);
-                    Renderer& clear();
+                    Renderer&  startRendering();
+                    // Binds only the rectangle: everything drawn is clipped to it and only it is uploaded on the next flash().
+                    // The rest of the picture keeps its contents, the rectangle itself has to be redrawn completely.
+                    Renderer&  startRendering(const SDL_Rect& rect) override;
+                    Renderer& finishRendering() override;
 
-                    Renderer& pixel(const int x, const int y, const SDL_Color& color);
-                    Renderer& pixel(const int x, const int y);
+                    // flash() for FrameTarget users
+                    void present(const SDL_Rect* srcs, const SDL_Rect* dests, size_t count) override;
 
-                    Renderer& line(int x0, int y0, int x1, int y1, const SDL_Color& color);
-                    Renderer& line(int x0, int y0, int x1, int y1);
+                    // New textures and back buffer of the new size, the whole picture gets uploaded on the next flash()
+                    bool resize(unsigned int sizeX, unsigned int sizeY) override;
 
-                    Renderer& circle(const int x, const int y, const unsigned int r, const SDL_Color& color);
-                    Renderer& circle(const int x, const int y, const unsigned int r);
+                    // Follows the window size: cheap, if the size hasn't changed; true, if the picture has to be redrawn
+                    bool fitWindow();
 
-                    Renderer& round(const int x, const int y, const unsigned int r, const SDL_Color& lineColor, const SDL_Color& fillColor);
-                    Renderer& round(const int x, const int y, const unsigned int r);
+        private:
 
-                    Renderer& applyShader
-                    (
-                        const int x, 
-                        const int y, 
-                        unsigned int w, 
-                        unsigned int h, 
-                        std::function<SDL_Color(int x, int y, const SDL_Color& color)> shader
-                    );
+            static const size_t TEXTURE_COUNT = 2;
 
-        private:
+            // More dirty rectangles than that are uploaded as their bounding box
+            static const size_t MAX_DIRTY_RECTS = 64;
 
             // Variables:
 
+                SDL_Window*   window_;
                 SDL_Renderer* renderer_;
-                SDL_Texture*  dest_;
 
-                unsigned int destSizeX_;
-                unsigned int destSizeY_;
-                
-                Uint8* pixelBuffer_;
+                SDL_Texture* textures_[TEXTURE_COUNT];
+                size_t       shown_; // The texture of the last flash()
 
-                SDL_Color lineColor_;
-                SDL_Color fillColor_;
+                std::vector<Uint32> back_;
+
+                // Regions drawn since the texture was uploaded last time, one list per texture
+                std::vector<SDL_Rect> dirty_[TEXTURE_COUNT];
 
             // Functions, that shouldn't appear anywhere at all:
 
@@ -106,26 +100,15 @@ namespace MySDL
                 
                 Renderer& operator=(const Renderer& renderer);
 
-            // Functions, that should not appear anywhere outside: 
-
-                Renderer& clearInsecure(const SDL_Color& color);
-
-                Renderer& pixelInsecure(const int x, const int y, const SDL_Color& color);
+            // Functions, that should not appear anywhere outside:
 
-                Renderer& lineInsecure(int x0, int y0, int x1, int y1, const SDL_Color& color);
+                void markDirty(const SDL_Rect& rect);
 
-                Renderer& circleInsecure(const int x, const int y, const unsigned int r, const SDL_Color& color);
+                // Textures and back buffer for sizeX * sizeY, the old ones are released first
+                void allocate(unsigned int sizeX, unsigned int sizeY);
 
-                Renderer& roundInsecure(const int x, const int y, const unsigned int r, const SDL_Color& lineColor, const SDL_Color& fillColor);
-
-                Renderer& applyShaderInsecure
-                (
-                    const int x, 
-                    const int y, 
-                    const unsigned int w, 
-                    const unsigned int h, 
-                    std::function<SDL_Color(int x, int y, const SDL_Color& color)> shader
-                );
+                // Uploads the dirty regions of the next texture and makes it the shown one
+                SDL_Texture* upload();
     };
 
 
@@ -133,14 +116,14 @@ namespace MySDL
     //{ Constructor && destructor
     //----------------------------------------------------------------------------
 
-        Renderer::Renderer(SDL_Window* window) :
+        Renderer::Renderer(SDL_Window* window, Uint32 flags /*= SDL_RENDERER_ACCELERATED*/) :
+            FrameTarget  (0, 0),
+            window_      (window),
             renderer_    (nullptr),
-            dest_        (nullptr), 
-            destSizeX_   (0),
-            destSizeY_   (0),
-            pixelBuffer_ (nullptr),
-            lineColor_   ({0, 0, 0, 255}),
-            fillColor_   ({0, 0, 0, 255})
+            textures_    (),
+            shown_       (0),
+            back_        (),
+            dirty_       ()
         {
             if (window == nullptr)
             {
@@ -157,21 +140,24 @@ namespace MySDL
             {
                 throw std::string("Renderer::constructor: window height is negative or 0\n") + std::string(SDL_GetError());
             }
-            destSizeX_ = windowSizeX;
-            destSizeY_ = windowSizeY;
 
-            renderer_ = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+            renderer_ = SDL_CreateRenderer(window, -1, flags);
             if (renderer_ == nullptr)
             {   
                 throw std::string("Renderer::constructor: SDL_CreateRenderer failed\n") + std::string(SDL_GetError());                 
             }
 
-            dest_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, destSizeX_, destSizeY_);
-            if (dest_ == nullptr)
+            try
+            {
+                allocate(windowSizeX, windowSizeY);
+            }
+            catch (...)
             {
+                for (SDL_Texture* texture : textures_) if (texture != nullptr) SDL_DestroyTexture(texture);
+
                 SDL_DestroyRenderer(renderer_);
 
-                throw std::string("Renderer::constructor: SDL_CreateTexture failed\n") + std::string(SDL_GetError()); 
+                throw;
             }
 
             // If we're here, the invariant is set, no assert(ok()) needed then, right?
@@ -179,7 +165,7 @@ namespace MySDL
 
         Renderer::~Renderer()
         {
-            SDL_DestroyTexture(dest_);
+            for (SDL_Texture* texture : textures_) if (texture != nullptr) SDL_DestroyTexture(texture);
 
             SDL_DestroyRenderer(renderer_);
         }
@@ -188,24 +174,6 @@ namespace MySDL
     //----------------------------------------------------------------------------
 
 
-    //----------------------------------------------------------------------------
-    //{ Getters && setters:
-    //----------------------------------------------------------------------------
-
-        size_t Renderer::getDestSizeX() const
-        {
-            return destSizeX_;
-        }
-
-        size_t Renderer::getDestSizeY() const
-        {
-            return destSizeY_;
-        } 
-
-    //}
-    //----------------------------------------------------------------------------
-
-
     //----------------------------------------------------------------------------
     //{ Functions
     //----------------------------------------------------------------------------
@@ -219,24 +187,14 @@ namespace MySDL
                 void Renderer::dump() const
                 {
                     std::cout << "\nRenderer::dump:"                << "\n"
-                              << "renderer_    == " << renderer_    << "\n"
-                              << "dest_        == " << dest_        << "\n"
-                              << "destSizeX_   == " << destSizeX_   << "\n"
-                              << "destSizeY_   == " << destSizeY_   << "\n"
-                              << "pixelBuffer_ == " << static_cast<void*>(pixelBuffer_) << "\n"
-                              << std::setfill('0') << std::right 
-                              << "lineColor_   ==" 
-                              << " r" << std::setw(3) << static_cast<int>(lineColor_.r)
-                              << " g" << std::setw(3) << static_cast<int>(lineColor_.g)
-                              << " b" << std::setw(3) << static_cast<int>(lineColor_.b)
-                              << " a" << std::setw(3) << static_cast<int>(lineColor_.a) << "\n"
-                              << "fillColor_   ==" 
-                              << " r" << std::setw(3) << static_cast<int>(fillColor_.r)
-                              << " g" << std::setw(3) << static_cast<int>(fillColor_.g)
-                              << " b" << std::setw(3) << static_cast<int>(fillColor_.b)
-                              << " a" << std::setw(3) << static_cast<int>(fillColor_.a) << "\n"
-                              << std::setfill(' ') << std::left
-                              <<std::endl;
+                              << "renderer_    == " << renderer_     << "\n"
+                              << "textures_[0] == " << textures_[0] << "\n"
+                              << "textures_[1] == " << textures_[1] << "\n"
+                              << "shown_       == " << shown_       << "\n"
+                              << "dirty_[0]    == " << dirty_[0].size() << " rectangles\n"
+                              << "dirty_[1]    == " << dirty_[1].size() << " rectangles\n";
+
+                    Canvas::dump();
                 }
 
             #else 
@@ -253,469 +211,208 @@ namespace MySDL
         //{ Additional
         //----------------------------------------------------------------------------
 
-            void Renderer::flash(const SDL_Rect* src /*= nullptr*/, const SDL_Rect* dest /*= nullptr*/) const
+            void Renderer::flash(const SDL_Rect* src /*= nullptr*/, const SDL_Rect* dest /*= nullptr*/)
             {
-                if (pixelBuffer_ != nullptr)
+                if (isBound())
                 {
-                   throw std::string("Renderer::render(): rendering is not finished (texture is still locked)");
+                   throw std::string("Renderer::render(): rendering is not finished");
                 }
 
-                if (SDL_RenderCopy(renderer_, dest_, src, dest) != 0)
+                SDL_Texture* texture = upload();
+
                 {
-                    throw std::string("Renderer::render(): SDL_RenderCopy failed.\n") + std::string(SDL_GetError());
+                    MORSE_TRACE_SCOPE("Renderer::copy");
+
+                    if (SDL_RenderCopy(renderer_, texture, src, dest) != 0)
+                    {
+                        throw std::string("Renderer::render(): SDL_RenderCopy failed.\n") + std::string(SDL_GetError());
+                    }
                 }
 
+                MORSE_TRACE_SCOPE("Renderer::present");
+
                 SDL_RenderPresent(renderer_);
             }
 
-            Renderer& Renderer::startRendering()
+            void Renderer::flash(const SDL_Rect* srcs, const SDL_Rect* dests, size_t count)
             {
-                if (pixelBuffer_ != nullptr)
-                {
-                    throw std::string("Renderer::startRendering(): rendering is already in process (texture is already locked)");  
-                } 
-
-                int pitch = 0;
-                if (SDL_LockTexture(dest_, nullptr, reinterpret_cast<void**>(&pixelBuffer_), &pitch) != 0)
+                if (isBound())
                 {
-                    throw std::string("Renderer::startRendering(): SDL_LockTexture failed\n") + std::string(SDL_GetError());
+                   throw std::string("Renderer::render(): rendering is not finished");
                 }
 
-                destSizeX_ = pitch/4;
+                SDL_Texture* texture = upload();
 
-                return *this;
-            }
-
-            Renderer& Renderer::finishRendering()
-            {
-                if (pixelBuffer_ == nullptr)
                 {
-                    throw std::string("Renderer::finishRendering(): rendering has not been started yet (texture is not locked)"); 
-                } 
+                    MORSE_TRACE_SCOPE("Renderer::copy");
 
-                SDL_UnlockTexture(dest_);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        if (SDL_RenderCopy(renderer_, texture, &srcs[i], &dests[i]) != 0)
+                        {
+                            throw std::string("Renderer::render(): SDL_RenderCopy failed.\n") + std::string(SDL_GetError());
+                        }
+                    }
+                }
 
-                pixelBuffer_ = nullptr;
+                // With vsync this is where the frame waits for the display
+                MORSE_TRACE_SCOPE("Renderer::present");
 
-                return *this;
+                SDL_RenderPresent(renderer_);
             }
 
-        //}
-        //----------------------------------------------------------------------------
-
-
-        //----------------------------------------------------------------------------
-        //{ Colors
-        //----------------------------------------------------------------------------
-
-            Renderer& Renderer::setLineColor(const SDL_Color& lineColor)
+            void Renderer::present(const SDL_Rect* srcs, const SDL_Rect* dests, size_t count)
             {
-                lineColor_ = lineColor;
-
-                return *this;
+                flash(srcs, dests, count);
             }
 
-            Renderer& Renderer::setFillColor(const SDL_Color& fillColor)
+            Renderer& Renderer::startRendering()
             {
-                fillColor_ = fillColor;
-
-                return *this;
+                return startRendering({0, 0, static_cast<int>(getDestSizeX()), static_cast<int>(getDestSizeY())});
             }
 
-        //}
-        //----------------------------------------------------------------------------
-
-
-        //----------------------------------------------------------------------------
-        //{ Rendering
-        //----------------------------------------------------------------------------
-
-            //----------------------------------------------------------------------------
-            //{ Clearing
-            //----------------------------------------------------------------------------
-
-                Renderer& Renderer::clearInsecure(const SDL_Color& color)
-                {
-                    for (size_t index = 0; index < 4 * destSizeX_ * destSizeY_; index += 4)
-                    {
-                        pixelBuffer_[index + 0] = color.r;
-                        pixelBuffer_[index + 1] = color.g;
-                        pixelBuffer_[index + 2] = color.b;
-                        pixelBuffer_[index + 3] = color.a;
-                    }
-
-                    return *this;
-                }
-
-                Renderer& Renderer::clear(const SDL_Color& color)
+            Renderer& Renderer::startRendering(const SDL_Rect& rect)
+            {
+                if (isBound())
                 {
-                    if (pixelBuffer_ == nullptr)
-                    {
-                        throw std::string("Renderer::clear(): rendering has not been started yet (texture is not locked)"); 
-                    }
+                    throw std::string("Renderer::startRendering(): rendering is already in process");  
+                } 
 
-                    return clearInsecure(color);
-                }
+                SDL_Rect picture = {0, 0, static_cast<int>(getDestSizeX()), static_cast<int>(getDestSizeY())}, bound = {};
 
-                Renderer& Renderer::clear()
+                if (SDL_IntersectRect(&rect, &picture, &bound) != SDL_TRUE)
                 {
-                    return clear(fillColor_);
+                    throw std::string("Renderer::startRendering(): the rectangle is outside the picture");
                 }
-                
-            //}
-            //----------------------------------------------------------------------------
 
+                bind(back_.data() + getDestSizeX() * bound.y + bound.x, getDestSizeX(), bound);
 
-            //----------------------------------------------------------------------------
-            //{ Pixel
-            //----------------------------------------------------------------------------
-
-                Renderer& Renderer::pixelInsecure(const int x, const int y, const SDL_Color& color)
-                {
-                    size_t index = (destSizeX_ * y + x) * 4;
-                    
-                    pixelBuffer_[index + 0] = color.r;
-                    pixelBuffer_[index + 1] = color.g;
-                    pixelBuffer_[index + 2] = color.b;
-                    pixelBuffer_[index + 3] = color.a;
-
-                    return *this;
-                }
+                return *this;
+            }
 
-                Renderer& Renderer::pixel(const int x, const int y, const SDL_Color& color)
+            Renderer& Renderer::finishRendering()
+            {
+                if (!isBound())
                 {
-                    if (pixelBuffer_ == nullptr)
-                    {
-                        throw std::string("Renderer::pixel(): rendering has not been started yet (texture is not locked)"); 
-                    }
-
-                    if (0 > x || x >= static_cast<int>(destSizeX_))
-                    {
-                        return *this;
-                    }
-
-                    if (0 > y || y >= static_cast<int>(destSizeY_))
-                    {
-                        return *this;
-                    }
-                    
-                    return pixelInsecure(x, y, color);
-                }
+                    throw std::string("Renderer::finishRendering(): rendering has not been started yet"); 
+                } 
 
-                Renderer& Renderer::pixel(const int x, const int y)
-                {
-                    return pixel(x, y, lineColor_);
-                }
+                MORSE_TRACE_INSTANT("Renderer::finishRendering");
 
-            //}
-            //----------------------------------------------------------------------------
+                markDirty(getBoundRect());
 
+                unbind();
 
-            //----------------------------------------------------------------------------
-            //{ Pixel
-            //----------------------------------------------------------------------------
+                return *this;
+            }
 
-                Renderer& Renderer::lineInsecure(int x0, int y0, int x1, int y1, const SDL_Color& color)
+            bool Renderer::resize(unsigned int sizeX, unsigned int sizeY)
+            {
+                if (isBound())
                 {
-                    bool swappedXandY = false;
+                    throw std::string("Renderer::resize(): rendering is not finished");
+                }
 
-                    if (abs(y1 - y0) > abs(x1 - x0))
-                    {
-                        std::swap(y0, x0);
-                        std::swap(y1, x1);
+                if (sizeX == getDestSizeX() && sizeY == getDestSizeY()) return false;
 
-                        swappedXandY = true;
-                    }
+                allocate(sizeX, sizeY);
 
-                    if (x1 < x0)
-                    {
-                        std::swap(x0, x1);
-                        std::swap(y0, y1);
-                    }
+                return true;
+            }
 
-                    int dX = x1 - x0;
-                    int dY = y1 - y0;
-                    int dX2 = dX << 1;
+            bool Renderer::fitWindow()
+            {
+                int windowSizeX = 0, windowSizeY = 0;
+                SDL_GetWindowSize(window_, &windowSizeX, &windowSizeY);
 
-                    int error2dX = 0;
-                    int deltaError = -(dY << 1);
+                // Minimized windows may report 0, the picture is kept for when they are back
+                if (windowSizeX <= 0 || windowSizeY <= 0) return false;
 
-                    for (int x = x0, y = y0; x <= x1; x++, error2dX += deltaError)
-                    {
-                        if (swappedXandY) pixelInsecure(y, x, color);
-                        else pixelInsecure(x, y, color);
+                return resize(windowSizeX, windowSizeY);
+            }
 
-                        if (error2dX < -dX)
-                        {
-                            error2dX += dX2;
-                            y++;
-                        }
-                        else if (error2dX > dX)
-                        {
-                            error2dX -= dX2;
-                            y--;
-                        }
-                    }
+            void Renderer::allocate(unsigned int sizeX, unsigned int sizeY)
+            {
+                for (SDL_Texture*& texture : textures_)
+                {
+                    if (texture != nullptr) SDL_DestroyTexture(texture);
 
-                    return *this;
+                    texture = nullptr;
                 }
 
-                Renderer& Renderer::line(int x0, int y0, int x1, int y1, const SDL_Color& color)
+                for (SDL_Texture*& texture : textures_)
                 {
-                    if (pixelBuffer_ == nullptr)
+                    texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, sizeX, sizeY);
+                    if (texture == nullptr)
                     {
-                        throw std::string("Renderer::line(): rendering has not been started yet (texture is not locked)"); 
+                        throw std::string("Renderer::allocate(): SDL_CreateTexture failed\n") + std::string(SDL_GetError());
                     }
-
-                    SDL_Rect screen = {0, 0, static_cast<int>(destSizeX_ - 1), static_cast<int>(destSizeY_ - 1)};
-
-                    SDL_IntersectRectAndLine(&screen, &x0, &y0, &x1, &y1);
-
-                    if (x0 < 0 || x0 >= static_cast<int>(destSizeX_) || y0 < 0 || y0 >= static_cast<int>(destSizeY_)) return *this;
-
-                    return lineInsecure(x0, y0, x1, y1, color);
                 }
 
-                Renderer& Renderer::line(int x0, int y0, int x1, int y1)
-                {
-                    return line(x0, y0, x1, y1, lineColor_);
-                }
-            
-            //}
-            //----------------------------------------------------------------------------
-
-
-            //----------------------------------------------------------------------------
-            //{ Circle
-            //----------------------------------------------------------------------------
+                setSize(sizeX, sizeY);
 
-                 Renderer& Renderer::circleInsecure(const int x, const int y, const unsigned int r, const SDL_Color& color)
-                 {
-                    int error = 0;                    
+                back_.assign(static_cast<size_t>(sizeX) * sizeY, 0);
 
-                    for (int relX = -r, relY = 0; relY < -relX; ++relY, error += 2 * relY + 1)
-                    {
-                        if (std::labs(error + 2 * relX + 1) < std::labs(error))
-                        {
-                            ++relX;
+                // Textures start with garbage: the first upload of each one is the whole picture
+                for (std::vector<SDL_Rect>& dirty : dirty_) dirty.clear();
 
-                            error += 2 * relX + 1;
-                        }
-
-                        pixelInsecure(x + relX, y + relY, color);
-                        pixelInsecure(x + relX, y - relY, color);
-                        pixelInsecure(x - relX, y + relY, color);
-                        pixelInsecure(x - relX, y - relY, color);
-                        pixelInsecure(x + relY, y + relX, color);
-                        pixelInsecure(x + relY, y - relX, color);
-                        pixelInsecure(x - relY, y + relX, color);
-                        pixelInsecure(x - relY, y - relX, color);   
-                    }
-
-                    return *this;
-                 }
-
-                 Renderer& Renderer::circle(const int x, const int y, const unsigned int r, const SDL_Color& color)
-                 {
-                    if (pixelBuffer_ == nullptr)
-                    {
-                        throw std::string("Renderer::circle(): rendering has not been started yet (texture is not locked)"); 
-                    }
+                markDirty({0, 0, static_cast<int>(sizeX), static_cast<int>(sizeY)});
+            }
 
-                    int error = 0;                    
+            void Renderer::markDirty(const SDL_Rect& rect)
+            {
+                for (std::vector<SDL_Rect>& dirty : dirty_)
+                {
+                    // The same tile is redrawn over and over: it is uploaded once anyway
+                    bool covered = false;
 
-                    for (int relX = -r, relY = 0; relY < -relX; ++relY, error += 2 * relY + 1)
+                    for (SDL_Rect& old : dirty)
                     {
-                        if (std::labs(error + 2 * relX + 1) < std::labs(error))
-                        {
-                            ++relX;
-
-                            error += 2 * relX + 1;
-                        }
-
-                        pixel(x + relX, y + relY, color);
-                        pixel(x + relX, y - relY, color);
-                        pixel(x - relX, y + relY, color);
-                        pixel(x - relX, y - relY, color);
-                        pixel(x + relY, y + relX, color);
-                        pixel(x + relY, y - relX, color);
-                        pixel(x - relY, y + relX, color);
-                        pixel(x - relY, y - relX, color);   
-                    }
-
-                    return *this;
-                 }
-
-                 Renderer& Renderer::circle(const int x, const int y, const unsigned int r)
-                 {
-                    return circle(x, y, r, lineColor_);
-                 }
-            
-            //}
-            //----------------------------------------------------------------------------
-
+                        SDL_Rect both = {};
+                        SDL_UnionRect(&old, &rect, &both);
 
-            //----------------------------------------------------------------------------
-            //{ Round
-            //----------------------------------------------------------------------------
-
-                 Renderer& Renderer::roundInsecure(const int x, const int y, const unsigned int r, const SDL_Color& lineColor, const SDL_Color& fillColor)
-                 {
-                    int error = 0;                    
-
-                    for (int relX = -r, relY = 0; relY < -relX; ++relY, error += 2 * relY + 1)
-                    {
-                        if (std::labs(error + 2 * relX + 1) < std::labs(error))
+                        if (both.x == old.x && both.y == old.y && both.w == old.w && both.h == old.h)
                         {
-                            ++relX;
-
-                            error += 2 * relX + 1;
+                            covered = true;
+                            break;
                         }
-
-                        pixelInsecure(x + relX, y + relY, lineColor);
-                        pixelInsecure(x + relX, y - relY, lineColor);
-                        pixelInsecure(x - relX, y + relY, lineColor);
-                        pixelInsecure(x - relX, y - relY, lineColor);
-                        pixelInsecure(x + relY, y + relX, lineColor);
-                        pixelInsecure(x + relY, y - relX, lineColor);
-                        pixelInsecure(x - relY, y + relX, lineColor);
-                        pixelInsecure(x - relY, y - relX, lineColor); 
-
-                        for (int curX = relX + 1; curX <= -relY; ++curX)
-                        {
-                            pixelInsecure(x + curX, y + relY, fillColor);
-                            pixelInsecure(x + curX, y - relY, fillColor);
-                            pixelInsecure(x - curX, y + relY, fillColor);
-                            pixelInsecure(x - curX, y - relY, fillColor);
-                            pixelInsecure(x + relY, y + curX, fillColor);
-                            pixelInsecure(x + relY, y - curX, fillColor);
-                            pixelInsecure(x - relY, y + curX, fillColor);
-                            pixelInsecure(x - relY, y - curX, fillColor); 
-                        }  
-                    }
-
-                    return *this;
-                 }
-
-                 Renderer& Renderer::round(const int x, const int y, const unsigned int r, const SDL_Color& color, const SDL_Color& fillColor)
-                 {
-                    if (pixelBuffer_ == nullptr)
-                    {
-                        throw std::string("Renderer::circle(): rendering has not been started yet (texture is not locked)"); 
                     }
 
-                    int error = 0;                    
+                    if (covered) continue;
 
-                    for (int relX = -r, relY = 0; relY < -relX; ++relY, error += 2 * relY + 1)
+                    if (dirty.size() == MAX_DIRTY_RECTS)
                     {
-                        if (std::labs(error + 2 * relX + 1) < std::labs(error))
-                        {
-                            ++relX;
-
-                            error += 2 * relX + 1;
-                        }
+                        for (size_t i = 1; i < dirty.size(); ++i) SDL_UnionRect(&dirty[0], &dirty[i], &dirty[0]);
 
-                        pixel(x + relX, y + relY, color);
-                        pixel(x + relX, y - relY, color);
-                        pixel(x - relX, y + relY, color);
-                        pixel(x - relX, y - relY, color);
-                        pixel(x + relY, y + relX, color);
-                        pixel(x + relY, y - relX, color);
-                        pixel(x - relY, y + relX, color);
-                        pixel(x - relY, y - relX, color); 
-
-                        for (int curX = relX + 1; curX <= -relY; ++curX)
-                        {
-                            pixel(x + curX, y + relY, fillColor);
-                            pixel(x + curX, y - relY, fillColor);
-                            pixel(x - curX, y + relY, fillColor);
-                            pixel(x - curX, y - relY, fillColor);
-                            pixel(x + relY, y + curX, fillColor);
-                            pixel(x + relY, y - curX, fillColor);
-                            pixel(x - relY, y + curX, fillColor);
-                            pixel(x - relY, y - curX, fillColor); 
-                        }   
+                        dirty.resize(1);
                     }
 
-                    return *this;
-                 }
-
-                 Renderer& Renderer::round(const int x, const int y, const unsigned int r)
-                 {
-                    return round(x, y, r, lineColor_, fillColor_);
-                 }
-
-            //}
-            //----------------------------------------------------------------------------
+                    dirty.push_back(rect);
+                }
+            }
 
+            SDL_Texture* Renderer::upload()
+            {
+                MORSE_TRACE_SCOPE("Renderer::upload");
 
-            //----------------------------------------------------------------------------
-            //{ Apply function on a rectangle
-            //----------------------------------------------------------------------------
+                size_t next = (shown_ + 1) % TEXTURE_COUNT;
 
-                Renderer& Renderer::applyShaderInsecure
-                (
-                    const int x, 
-                    const int y, 
-                    const unsigned int w, 
-                    const unsigned int h, 
-                    std::function<SDL_Color(int x, int y, const SDL_Color& color)> shader
-                )
+                for (const SDL_Rect& rect : dirty_[next])
                 {
-                    for (unsigned int curY = y; curY < y + h; ++curY)
-                    {
-                        size_t curIndex = (destSizeX_ * curY + x) * 4;
-
-                        for (unsigned int curX = x; curX < x + w; ++curX, curIndex += 4)
-                        {                        
-                            SDL_Color curColor =
-                            {
-                                pixelBuffer_[curIndex + 0],
-                                pixelBuffer_[curIndex + 1],
-                                pixelBuffer_[curIndex + 2],
-                                pixelBuffer_[curIndex + 3]
-                            };
-
-                            pixelInsecure(curX, curY, shader(curX, curY, curColor));
-                        }
-                    }
-
-                    return *this;
-                }
+                    const Uint32* pixels = back_.data() + getDestSizeX() * rect.y + rect.x;
 
-                Renderer& Renderer::applyShader(int x, int y, unsigned int w, unsigned int h, std::function<SDL_Color(int x, int y, const SDL_Color& color)> shader)
-                {
-                    if (pixelBuffer_ == nullptr)
+                    if (SDL_UpdateTexture(textures_[next], &rect, pixels, static_cast<int>(getDestSizeX() * sizeof(Uint32))) != 0)
                     {
-                        throw std::string("Renderer::applyFunction(): rendering has not been started yet (texture is not locked)"); 
-                    }
-
-                    if (x >= static_cast<int>(destSizeX_) || y >= static_cast<int>(destSizeY_)) return *this;
-
-                    if (x < 0) 
-                    {   
-                        if (-x > static_cast<int>(w)) return *this;
-                        
-                        w += x;
-                        x = 0;
+                        throw std::string("Renderer::render(): SDL_UpdateTexture failed.\n") + std::string(SDL_GetError());
                     }
+                }
 
-                    if (y < 0) 
-                    {   
-                        if (-y > static_cast<int>(h)) return *this;
-                        
-                        h += y;
-                        y = 0;
-                    }
+                dirty_[next].clear();
 
-                    if (x + w > destSizeX_) w = destSizeX_ - x;
-                    if (y + h > destSizeY_) h = destSizeY_ - y;
+                shown_ = next;
 
-                    return applyShaderInsecure(x, y, w, h, shader);
-                }
-            
-            //}
-            //----------------------------------------------------------------------------
+                return textures_[shown_];
+            }
 
         //}
         //----------------------------------------------------------------------------
@@ -0,0 +1,292 @@
+#ifndef MY_SDL_THREAD_POOL_HPP_INCLUDED
+#define MY_SDL_THREAD_POOL_HPP_INCLUDED
+
+//----------------------------------------------------------------------------
+//{ Includes
+//----------------------------------------------------------------------------
+
+    #include <atomic>
+    #include <condition_variable>
+    #include <deque>
+    #include <exception>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+
+//}
+//----------------------------------------------------------------------------
+
+
+namespace MySDL
+{
+
+//----------------------------------------------------------------------------
+//{ ThreadPool
+//----------------------------------------------------------------------------
+
+    // Persistent workers for data-parallel loops. Every participant (the workers and the
+    // calling thread) gets its own queue of task indices and steals from the others when
+    // its own queue runs dry, so uneven tasks even out.
+    class ThreadPool
+    {
+        public:
+
+            // Constructor && destructor:
+
+                // threadCount counts the calling thread too, 0 means one per hardware thread
+                explicit ThreadPool(size_t threadCount = 0);
+
+                ~ThreadPool();
+
+            // Getters:
+
+                size_t getThreadCount() const;
+
+            // Functions:
+
+                // Runs task(index) for every index in [0, count) and returns when all are done.
+                // The first exception thrown by a task is rethrown here.
+                template <typename Task>
+                void parallelFor(size_t count, Task&& task);
+
+        private:
+
+            struct WorkQueue
+            {
+                std::mutex         mutex;
+                std::deque<size_t> indices;
+            };
+
+            // Variables:
+
+                std::vector<std::unique_ptr<WorkQueue>> queues_;
+                std::vector<std::thread>                threads_;
+
+                std::mutex              submitMutex_; // One loop at a time
+                std::mutex              stateMutex_;
+                std::condition_variable jobReady_;
+                std::condition_variable jobDone_;
+
+                std::function<void(size_t)> job_;
+                unsigned long long          jobGeneration_;
+                std::atomic<size_t>         pending_;
+                std::exception_ptr          error_;
+                bool                        stopping_;
+
+            // Functions, that shouldn't appear anywhere at all:
+
+                ThreadPool(const ThreadPool& pool);
+
+                ThreadPool& operator=(const ThreadPool& pool);
+
+            // Functions, that should not appear anywhere outside:
+
+                void workerLoop(size_t self);
+
+                // Takes an index from the own queue or steals one, false if there is no work left
+                bool takeIndex(size_t self, size_t& index);
+
+                void runIndices(size_t self);
+    };
+
+
+    //----------------------------------------------------------------------------
+    //{ Constructor && destructor
+    //----------------------------------------------------------------------------
+
+        ThreadPool::ThreadPool(size_t threadCount /*= 0*/) :
+            queues_        (),
+            threads_       (),
+            submitMutex_   (),
+            stateMutex_    (),
+            jobReady_      (),
+            jobDone_       (),
+            job_           (),
+            jobGeneration_ (0),
+            pending_       (0),
+            error_         (),
+            stopping_      (false)
+        {
+            if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+            if (threadCount == 0) threadCount = 1;
+
+            for (size_t i = 0; i < threadCount; ++i) queues_.emplace_back(new WorkQueue{});
+
+            // Participant 0 is the thread that calls parallelFor
+            for (size_t i = 1; i < threadCount; ++i) threads_.emplace_back([this, i] { workerLoop(i); });
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{stateMutex_};
+
+                stopping_ = true;
+            }
+
+            jobReady_.notify_all();
+
+            for (std::thread& thread : threads_) thread.join();
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Getters
+    //----------------------------------------------------------------------------
+
+        size_t ThreadPool::getThreadCount() const
+        {
+            return queues_.size();
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+
+    //----------------------------------------------------------------------------
+    //{ Functions
+    //----------------------------------------------------------------------------
+
+        template <typename Task>
+        void ThreadPool::parallelFor(size_t count, Task&& task)
+        {
+            if (count == 0) return;
+
+            if (queues_.size() == 1 || count == 1)
+            {
+                for (size_t index = 0; index < count; ++index) task(index);
+
+                return;
+            }
+
+            std::lock_guard<std::mutex> submitLock{submitMutex_};
+
+            // The job has to be set before any index is visible: a worker may still be stealing
+            {
+                std::lock_guard<std::mutex> lock{stateMutex_};
+
+                job_ = [&task] (size_t index) { task(index); };
+                error_ = nullptr;
+                pending_.store(count);
+                ++jobGeneration_;
+            }
+
+            // Dealing indices out round-robin, neighbours go to different threads
+            for (size_t index = 0; index < count; ++index)
+            {
+                WorkQueue& queue = *queues_[index % queues_.size()];
+
+                std::lock_guard<std::mutex> lock{queue.mutex};
+
+                queue.indices.push_back(index);
+            }
+
+            jobReady_.notify_all();
+
+            runIndices(0);
+
+            std::unique_lock<std::mutex> lock{stateMutex_};
+
+            jobDone_.wait(lock, [this] { return pending_.load() == 0; });
+
+            job_ = nullptr;
+
+            if (error_ != nullptr) std::rethrow_exception(error_);
+        }
+
+        void ThreadPool::workerLoop(size_t self)
+        {
+            unsigned long long seenGeneration = 0;
+
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock{stateMutex_};
+
+                    jobReady_.wait(lock, [this, seenGeneration] { return stopping_ || jobGeneration_ != seenGeneration; });
+
+                    if (stopping_) return;
+
+                    seenGeneration = jobGeneration_;
+                }
+
+                runIndices(self);
+            }
+        }
+
+        bool ThreadPool::takeIndex(size_t self, size_t& index)
+        {
+            // Own queue from the front:
+            {
+                WorkQueue& own = *queues_[self];
+
+                std::lock_guard<std::mutex> lock{own.mutex};
+
+                if (!own.indices.empty())
+                {
+                    index = own.indices.front();
+                    own.indices.pop_front();
+
+                    return true;
+                }
+            }
+
+            // Somebody else's from the back:
+            for (size_t offset = 1; offset < queues_.size(); ++offset)
+            {
+                WorkQueue& victim = *queues_[(self + offset) % queues_.size()];
+
+                std::lock_guard<std::mutex> lock{victim.mutex};
+
+                if (!victim.indices.empty())
+                {
+                    index = victim.indices.back();
+                    victim.indices.pop_back();
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void ThreadPool::runIndices(size_t self)
+        {
+            size_t index = 0;
+
+            while (takeIndex(self, index))
+            {
+                try
+                {
+                    job_(index);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock{stateMutex_};
+
+                    if (error_ == nullptr) error_ = std::current_exception();
+                }
+
+                if (pending_.fetch_sub(1) == 1)
+                {
+                    std::lock_guard<std::mutex> lock{stateMutex_};
+
+                    jobDone_.notify_all();
+                }
+            }
+        }
+
+    //}
+    //----------------------------------------------------------------------------
+
+//}
+//----------------------------------------------------------------------------
+
+}
+
+#endif /*MY_SDL_THREAD_POOL_HPP_INCLUDED*/
\ No newline at end of file
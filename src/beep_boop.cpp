@@ -1,8 +1,15 @@
 #include <iostream>
+#include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <csignal>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <thread>
-#include <cstdlib>
+
+#include <unistd.h>
 
 #include "queue/Queue.hpp"
 #include "queue/VaException.hpp"
@@ -11,109 +18,278 @@
 
 #include "renderers/MorseGraphicRenderer.hpp"
 #include "renderers/MorseConsoleRenderer.hpp"
+#include "renderers/MorseAudioRenderer.hpp"
+
+#include "pipeline/MorsePipeline.hpp"
+
+#include "server/MorseServer.hpp"
 
-// Threads:
+// Main:
+
+MorseCode START_CODE = "eee eee !!! !!! !!!";
 
-std::mutex queue_mutex;
+const char USAGE[] =
+	"Usage: beep_boop [--console] [--graphic] [--audio] [--stats] [--latency] [--metrics METRICS_PATH] [--trace TRACE_PATH]\n"
+	"       beep_boop --offscreen FRAMES_PATH [--raw] [--console] [--audio] [--stats] [--latency] [--metrics METRICS_PATH] [--trace TRACE_PATH]\n"
+	"       beep_boop --server SOCKET_PATH [--threads N] [--stats]\n"
+	"Renderers are driven from one schedule at the same time, console by default.\n"
+	"Offscreen mode writes video frames (PPM, or raw RGBA with --raw; \"-\" is stdout) without a window,\n"
+	"as fast as they are drawn, so the output is the same on every run.\n"
+	"--latency prints latency histograms at exit, SIGUSR1 prints them at any moment.\n"
+	"--metrics METRICS_PATH keeps queue and stage counters there (Prometheus text format), rewritten every second.\n"
+	"--trace TRACE_PATH writes a Chrome trace (JSON) of the run, if built with -DMORSE_TRACE.\n"
+	"In server mode every client of the unix socket gets its text back as timed morse.\n";
 
-void threadOut(VaQueue::Queue<char, 100>& queue)
+// Server mode:
+
+std::atomic<bool> serverInterrupted{false};
+
+void interruptServer(int)
 {
-	try
-	{
-		// Main cycle:
-		bool previousWasSentenceSpace = true;
+	serverInterrupted.store(true);
+}
 
-		while (queue.size() != 0)
-		{
-			char curChar = 0;
+// Latency dumps:
 
-			// Critical section:
-			{
-				std::lock_guard<std::mutex> lock{queue_mutex};
+std::atomic<bool> latencyDumpRequested{false};
 
-				curChar = queue.pop_front();
-			}
+void requestLatencyDump(int)
+{
+	latencyDumpRequested.store(true);
+}
 
-			// Normal section:
-			auto curMorseCode = morseFromChar(curChar);
+// Metrics file:
 
-			if (!previousWasSentenceSpace && curMorseCode[0] != '<') MorseConsoleRender(' ');
+const unsigned METRICS_PERIOD = 1000; // milliseconds
 
-			for (size_t i = 0; curMorseCode[i] != '\0'; ++i)
-			{
-				if (curMorseCode[i] == '<') previousWasSentenceSpace = true;
-				else previousWasSentenceSpace = false;
+// Written aside and renamed, so a reader never sees half a file
+void writeMetricsFile(const MorsePipeline& pipeline, const std::string& path)
+{
+	std::string written = path + ".tmp";
 
-				MorseConsoleRender(curMorseCode[i]);
+	{
+		std::ofstream file{written};
 
-				if (curMorseCode[i + 1] != '\0') MorseConsoleRender('_');
-			}
+		pipeline.writeMetrics(file);
+
+		if (!file)
+		{
+			throw VaExc::Exception(VAEXC_MSG("Metrics: can't write %s", written.c_str()), VAEXC_POS);
 		}
 	}
+
+	if (std::rename(written.c_str(), path.c_str()) != 0)
+	{
+		throw VaExc::Exception(VAEXC_MSG("Metrics: can't rename %s: %s", written.c_str(), std::strerror(errno)), VAEXC_POS);
+	}
+}
+
+// The periodic writes only report a failure, the morse goes on; the one at exit throws.
+// Returns false on a failure, which is printed once for a run of failures.
+bool tryWriteMetricsFile(const MorsePipeline& pipeline, const std::string& path, bool failedBefore)
+{
+	try
+	{
+		writeMetricsFile(pipeline, path);
+
+		return true;
+	}
 	catch (VaExc::Exception& exc)
 	{
-		std::cout << exc.what() << std::endl;
+		if (!failedBefore) std::cerr << exc.what() << std::endl;
 	}
-	catch (...)
+
+	return false;
+}
+
+// 0 for anything but a whole number
+size_t parseCount(const char* text)
+{
+	// strtoul() takes "-1" too, as a huge number
+	if (!std::isdigit(static_cast<unsigned char>(text[0]))) return 0;
+
+	char* end = nullptr;
+	unsigned long count = std::strtoul(text, &end, 10);
+
+	return *end == '\0' ? count : 0;
+}
+
+int runServer(const char* path, size_t threads, bool printStats)
+{
+	MorseServer server{path, threads};
+
+	std::signal(SIGINT,  interruptServer);
+	std::signal(SIGTERM, interruptServer);
+
+	server.start();
+
+	while (!serverInterrupted.load() && !server.stopped())
 	{
-		std::cout << "Unexpected exception" << std::endl;
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 	}
+
+	server.stop();
+	server.join();
+
+	for (const std::string& error : server.errors()) std::cout << error << std::endl;
+
+	if (printStats) server.dumpStats(std::cerr);
+
+	return server.errors().empty() ? 0 : 1;
 }
 
-void threadIn(VaQueue::Queue<char, 100>& queue, const std::thread& thr1)
+int main(int argc, char* argv[])
 {
-	char input = 0;
+	bool useConsole = false;
+	bool useGraphic = false;
+	bool useAudio   = false;
+	bool printStats = false;
+	bool printLatency = false;
+
+	const char* tracePath     = nullptr;
+	const char* metricsPath   = nullptr;
+
+	const char* offscreenPath = nullptr;
+	bool        rawFrames     = false;
+
+	const char* serverPath    = nullptr;
+	size_t      serverThreads = 2;
 
-	do
+	for (int i = 1; i < argc; ++i)
 	{
-		input = std::getchar();
+		if      (std::strcmp(argv[i], "--console") == 0) useConsole = true;
+		else if (std::strcmp(argv[i], "--graphic") == 0) useGraphic = true;
+		else if (std::strcmp(argv[i], "--audio"  ) == 0) useAudio   = true;
+		else if (std::strcmp(argv[i], "--stats"  ) == 0) printStats = true;
+		else if (std::strcmp(argv[i], "--raw"    ) == 0) rawFrames  = true;
+		else if (std::strcmp(argv[i], "--latency") == 0) printLatency = true;
+		else if (std::strcmp(argv[i], "--offscreen") == 0 && i + 1 < argc) offscreenPath = argv[++i];
+		else if (std::strcmp(argv[i], "--trace"    ) == 0 && i + 1 < argc) tracePath     = argv[++i];
+		else if (std::strcmp(argv[i], "--metrics"  ) == 0 && i + 1 < argc) metricsPath   = argv[++i];
+		else if (std::strcmp(argv[i], "--server" ) == 0 && i + 1 < argc) serverPath    = argv[++i];
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) serverThreads = parseCount(argv[++i]);
+		else
+		{
+			std::cout << USAGE;
+			return 1;
+		}
+	}
 
-		// Critical section:
-		std::lock_guard<std::mutex> lock{queue_mutex};
+	// A server without workers would never answer anyone, raw frames need an offscreen video to be written to
+	if (serverThreads < 1 || (rawFrames && offscreenPath == nullptr))
+	{
+		std::cout << USAGE;
+		return 1;
+	}
+
+	if (serverPath != nullptr)
+	{
+		try
+		{
+			return runServer(serverPath, serverThreads, printStats);
+		}
+		catch (VaExc::Exception& exc)
+		{
+			std::cout << exc.what() << std::endl;
+		}
+		catch (std::exception& exc)
+		{
+			std::cout << exc.what() << std::endl;
+		}
+		catch (...)
+		{
+			std::cout << "Unexpected exception" << std::endl;
+		}
 
-		queue.push_back(input);
+		return 1;
 	}
-	while
-	(
-		input != '\0' &&
-		thr1.joinable()
-	);
-}
 
-// Main:
+	if (tracePath != nullptr && !morse_trace::COMPILED_IN)
+	{
+		std::cout << "Tracing is not built in, rebuild with -DMORSE_TRACE" << std::endl;
+		return 1;
+	}
 
-MorseCode START_CODE = "eee eee !!! !!! !!!";
+	if (!useGraphic && !useAudio && offscreenPath == nullptr) useConsole = true;
 
-int main()
-{
 	try
 	{
 		MorseConsoleInit();
 
-		// Queue init
-		VaQueue::Queue<char, 100> queue{};
+		// Before the render threads start; video is left to the graphic renderer's thread
+		if (useAudio) MorseAudioInit();
 
-		for (size_t i = 0; START_CODE[i] != '\0'; ++i) queue.push_back(START_CODE[i]);
+		// Pipeline init:
+		// Offscreen frames follow the times of the elements, not the clock
+		MorsePipeline pipeline{STDIN_FILENO, START_CODE, offscreenPath == nullptr};
 
-		// Thread init:
-		std::thread thr1{threadOut, std::ref(queue)};
+		if (useConsole) pipeline.addRenderer("console", std::unique_ptr<MorseRendererInterface>{new MorseConsoleRenderer{}});
+		if (useGraphic) pipeline.addRenderer("graphic", std::unique_ptr<MorseRendererInterface>{new MorseGraphicRenderer{}});
+		if (useAudio  ) pipeline.addRenderer("audio",   std::unique_ptr<MorseRendererInterface>{new MorseAudioRenderer  {}});
 
-		threadIn(queue, thr1);
+		if (offscreenPath != nullptr)
+		{
+			MySDL::FrameFormat format = rawFrames ? MySDL::FrameFormat::Raw : MySDL::FrameFormat::Ppm;
 
-		thr1.join();
+			pipeline.addRenderer("offscreen", std::unique_ptr<MorseRendererInterface>{new MorseGraphicRenderer{offscreenPath, format}});
+		}
+
+		std::signal(SIGUSR1, requestLatencyDump);
+
+		if (tracePath != nullptr) morse_trace::start(tracePath);
+
+		pipeline.start();
+
+		bool metricsFailed = false;
+
+		// Signal handlers can't print, the main thread does it for them
+		for (unsigned waited = 0; !pipeline.finished(); waited += 100)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+			if (latencyDumpRequested.exchange(false)) pipeline.dumpLatency(std::cerr);
+
+			if (metricsPath != nullptr && waited % METRICS_PERIOD == 0)
+			{
+				metricsFailed = !tryWriteMetricsFile(pipeline, metricsPath, metricsFailed);
+			}
+		}
+
+		pipeline.join();
+
+		if (useAudio) MorseAudioQuit();
+
+		if (metricsPath != nullptr) writeMetricsFile(pipeline, metricsPath);
+
+		morse_trace::stop();
 
 		MorseConsoleQuit();
+
+		for (const std::string& error : pipeline.errors()) std::cout << error << std::endl;
+
+		if (printStats) pipeline.dumpStats(std::cerr);
+
+		if (printLatency) pipeline.dumpLatency(std::cerr);
 	}
 	catch (VaExc::Exception& exc)
 	{
+		if (useAudio) MorseAudioQuit();
+		MorseConsoleQuit();
+
 		std::cout << exc.what() << std::endl;
 	}
 	catch (std::exception& exc)
 	{
+		if (useAudio) MorseAudioQuit();
+		MorseConsoleQuit();
+
 		std::cout << exc.what() << std::endl;
 	}
 	catch (...)
 	{
+		if (useAudio) MorseAudioQuit();
+		MorseConsoleQuit();
+
 		std::cout << "Unexpected exception" << std::endl;
 	}
 
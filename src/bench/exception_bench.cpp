@@ -0,0 +1,382 @@
+// VaExc::Exception cost benchmark: throw/catch through "caused by" chains up to MAX_EXC_COUNT, copies,
+// what() formatting and the object size, next to std::runtime_error and the Status error path.
+// Then checks that truncation (NOT_ENOUGH_SPACE) works and that what() never writes past its
+// bounds; a broken check makes the exit status 1, so the numbers are never read off a broken build.
+//
+// Build (from src/):
+//     g++ -std=c++17 -O2 -DNDEBUG bench/exception_bench.cpp -o exception_bench
+// Run:
+//     ./exception_bench [--ms MILLISECONDS]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../queue/VaException.hpp"
+
+namespace exception_bench
+{
+	using Clock = std::chrono::steady_clock;
+
+	using namespace VaExc;
+
+	// Every case runs at least that long
+	long long minimumNs = 200 * 1000 * 1000;
+
+	// Results go there, so the compiler can't throw the work away
+	volatile size_t sink = 0;
+
+	// Calls batch() until the time is up, returns ns per call
+	template <typename Batch>
+	double measure(Batch&& batch)
+	{
+		batch();
+
+		long long calls = 0;
+
+		Clock::time_point start = Clock::now();
+		long long elapsed = 0;
+
+		do
+		{
+			batch();
+			++calls;
+
+			elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+		}
+		while (elapsed < minimumNs);
+
+		return static_cast<double>(elapsed) / calls;
+	}
+
+	void report(const char* name, const std::string& variant, double ns)
+	{
+		std::printf("%-22s %-14s %12.1f\n", name, variant.c_str(), ns);
+	}
+
+	std::string depthName(size_t depth)
+	{
+		return "depth " + std::to_string(depth);
+	}
+
+	//-----------------------------------------------------------
+	// Throwing:
+	//-----------------------------------------------------------
+
+	// Not inlined: the throw has to come from a real call, the way it does in the queue
+	[[noreturn]] __attribute__((noinline)) void throwVaExc(size_t count)
+	{
+		throw Exception(VAEXC_MSG("Queue overflow: can't push %zu elements", count), VAEXC_POS);
+	}
+
+	// Every level catches the cause and throws it again wrapped, like a stage boundary does
+	__attribute__((noinline)) void throwVaExcChain(size_t depth, size_t count)
+	{
+		if (depth == 0) return;
+		if (depth == 1) throwVaExc(count);
+
+		try
+		{
+			throwVaExcChain(depth - 1, count);
+		}
+		catch (Exception& exc)
+		{
+			throw Exception(VAEXC_MSG("Level %zu failed", depth), VAEXC_POS, exc);
+		}
+	}
+
+	[[noreturn]] __attribute__((noinline)) void throwRuntimeError(size_t count)
+	{
+		char msg[_control::MAX_MSG_SIZE + 1];
+		std::snprintf(msg, sizeof(msg), "Queue overflow: can't push %zu elements", count);
+
+		throw std::runtime_error(msg);
+	}
+
+	__attribute__((noinline)) void throwRuntimeErrorChain(size_t depth, size_t count)
+	{
+		if (depth == 0) return;
+		if (depth == 1) throwRuntimeError(count);
+
+		try
+		{
+			throwRuntimeErrorChain(depth - 1, count);
+		}
+		catch (std::runtime_error& exc)
+		{
+			// What a std-only code base does to keep the cause: put its text into the new message
+			throw std::runtime_error("Level " + std::to_string(depth) + " failed\n\nCaused by:\n" + exc.what());
+		}
+	}
+
+	__attribute__((noinline)) Status failStatus(size_t count)
+	{
+		return VAEXC_STATUS(Errc::Overflow, "Queue overflow: can't push %lld elements", count);
+	}
+
+	Exception makeChain(size_t depth)
+	{
+		try
+		{
+			throwVaExcChain(depth, depth);
+		}
+		catch (Exception& exc)
+		{
+			return exc;
+		}
+
+		return Exception("Unreachable"_msg);
+	}
+
+	void benchThrow()
+	{
+		for (size_t depth = 1; depth <= _control::MAX_EXC_COUNT; ++depth)
+		{
+			double ns = measure([depth]
+			{
+				try { throwVaExcChain(depth, depth); }
+				catch (Exception& exc) { sink = sink + 1; }
+			});
+
+			report("throw/catch VaExc", depthName(depth), ns);
+		}
+
+		for (size_t depth = 1; depth <= _control::MAX_EXC_COUNT; ++depth)
+		{
+			double ns = measure([depth]
+			{
+				try { throwRuntimeErrorChain(depth, depth); }
+				catch (std::runtime_error& exc) { sink = sink + 1; }
+			});
+
+			report("throw/catch runtime", depthName(depth), ns);
+		}
+
+		// Errors by value: the caller handles them without an exception ever built
+		double ns = measure([]
+		{
+			for (size_t i = 0; i < 1024; ++i) sink = sink + static_cast<size_t>(failStatus(i).code());
+		});
+
+		report("Status return", "", ns / 1024);
+	}
+
+	//-----------------------------------------------------------
+	// Copying and what():
+	//-----------------------------------------------------------
+
+	void benchCopyAndWhat()
+	{
+		for (size_t depth = 1; depth <= _control::MAX_EXC_COUNT; ++depth)
+		{
+			Exception chain = makeChain(depth);
+
+			double copyNs = measure([&chain]
+			{
+				Exception copy{chain};
+				sink = sink + sizeof(copy);
+			});
+
+			double whatNs = measure([&chain]
+			{
+				sink = sink + std::strlen(chain.what());
+			});
+
+			report("copy VaExc",   depthName(depth), copyNs);
+			report("what() VaExc", depthName(depth), whatNs);
+		}
+
+		std::runtime_error error{"Queue overflow: can't push 1 elements"};
+
+		double copyNs = measure([&error]
+		{
+			std::runtime_error copy{error};
+			sink = sink + std::strlen(copy.what());
+		});
+
+		double whatNs = measure([&error]
+		{
+			sink = sink + std::strlen(error.what());
+		});
+
+		report("copy runtime",   "", copyNs);
+		report("what() runtime", "", whatNs);
+
+		// Turning a Status into an Exception at an API boundary
+		Status status = failStatus(3);
+
+		double raiseNs = measure([&status]
+		{
+			try { status.raise(); }
+			catch (Exception& exc) { sink = sink + 1; }
+		});
+
+		report("Status raise/catch", "", raiseNs);
+	}
+
+	//-----------------------------------------------------------
+	// Truncation checks:
+	//-----------------------------------------------------------
+
+	int failedChecks = 0;
+
+	void check(bool passed, const char* what)
+	{
+		std::printf("%-60s %s\n", what, passed ? "ok" : "FAILED");
+
+		if (!passed) ++failedChecks;
+	}
+
+	bool endsWith(const std::string& text, const std::string& end)
+	{
+		return text.size() >= end.size() && text.compare(text.size() - end.size(), end.size(), end) == 0;
+	}
+
+	size_t count(const std::string& text, const std::string& part)
+	{
+		size_t found = 0;
+
+		for (size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) ++found;
+
+		return found;
+	}
+
+	void checkTruncation()
+	{
+		const std::string EXPLANATION = "\nExplanation: ";
+		const std::string CAUSED_BY   = "\n\nCaused by:\n";
+		const std::string MARK        = _control::NOT_ENOUGH_SPACE;
+
+		// A message longer than MAX_MSG_SIZE is cut to it, silently (the way snprintf cuts it)
+		{
+			std::string   longText(2 * _control::MAX_MSG_SIZE, 'x');
+			Exception     exc{VAEXC_MSG("%s", longText.c_str())};
+			std::string   text = exc.what();
+
+			check(text == EXPLANATION + longText.substr(0, _control::MAX_MSG_SIZE), "message is cut to MAX_MSG_SIZE");
+		}
+
+		// A message that fits is kept whole
+		{
+			std::string longText(_control::MAX_MSG_SIZE, 'y');
+			Exception   exc{VAEXC_MSG("%s", longText.c_str()), "file"_file, 7_line};
+			std::string text = exc.what();
+
+			check(text == EXPLANATION + longText + "\nIn file: file\nIn line: 7", "message of exactly MAX_MSG_SIZE is kept");
+		}
+
+		// Pieces that don't fit into MAX_INFO_SIZE become NOT_ENOUGH_SPACE, the rest stays
+		{
+			std::string longName(_control::MAX_INFO_SIZE, 'f');
+			Exception   exc{"short"_msg, _wrappers::ArgFunction(longName.c_str()), 12_line};
+			std::string text = exc.what();
+
+			check(text == EXPLANATION + "short" + MARK + "\nIn line: 12", "piece past MAX_INFO_SIZE becomes NOT_ENOUGH_SPACE");
+		}
+
+		// However many pieces don't fit, the info stays within MAX_INFO_SIZE
+		{
+			std::string longName(_control::MAX_INFO_SIZE - 30, 'n');
+			Exception   exc{_wrappers::ArgFilename(longName.c_str()), _wrappers::ArgFilename(longName.c_str()),
+			                _wrappers::ArgFilename(longName.c_str()), _wrappers::ArgFilename(longName.c_str()),
+			                _wrappers::ArgFilename(longName.c_str()), _wrappers::ArgFilename(longName.c_str())};
+			std::string text = exc.what();
+
+			check(text.size() <= _control::MAX_INFO_SIZE,        "info never grows past MAX_INFO_SIZE");
+			check(endsWith(text, MARK) && count(text, MARK) >= 1, "overflowing pieces end with NOT_ENOUGH_SPACE");
+		}
+
+		// Foreign exception text longer than the info is replaced by NOT_ENOUGH_SPACE
+		{
+			std::string longText(2 * _control::MAX_INFO_SIZE, 'r');
+			Exception   exc{"outer"_msg, std::runtime_error(longText)};
+			std::string text = exc.what();
+
+			check(text == EXPLANATION + "outer" + CAUSED_BY + MARK, "too long cause text becomes NOT_ENOUGH_SPACE");
+		}
+
+		// Chains keep MAX_EXC_COUNT entries, longer ones are cut, never read past the end
+		{
+			Exception   full = makeChain(_control::MAX_EXC_COUNT);
+			Exception   over{"one more"_msg, std::move(full)};
+			std::string text = over.what();
+
+			check(count(text, CAUSED_BY) == _control::MAX_EXC_COUNT - 1, "chains are cut to MAX_EXC_COUNT entries");
+			check(text.find("one more") == EXPLANATION.size(),           "the newest entry comes first");
+		}
+
+		// Strings are copied when the exception is made, so what() doesn't depend on their lifetime
+		{
+			std::string temporary = "before";
+			Exception   exc{VAEXC_MSG("%s", temporary.c_str())};
+			temporary.assign("after!");
+
+			check(std::string(exc.what()) == EXPLANATION + "before", "string arguments are kept by value");
+		}
+
+		// So are plain messages, file and function names
+		{
+			std::string msg  = "plain";
+			std::string file = "file.cpp";
+			std::string func = "function";
+
+			Exception exc{_wrappers::ArgMsg(msg.c_str()), _wrappers::ArgFilename(file.c_str()), _wrappers::ArgFunction(func.c_str())};
+
+			msg .assign(msg .size(), '?');
+			file.assign(file.size(), '?');
+			func.assign(func.size(), '?');
+
+			check(std::string(exc.what()) == EXPLANATION + "plain\nIn file: file.cpp\nIn function: function",
+			      "message, file and function are kept by value");
+		}
+
+		// Everything at its biggest at once still fits into the what() buffer
+		{
+			std::string longText(2 * _control::MAX_INFO_SIZE, 'z');
+
+			Exception chain{VAEXC_MSG("%s", longText.c_str()), _wrappers::ArgFilename(longText.c_str())};
+
+			for (size_t depth = 1; depth < _control::MAX_EXC_COUNT; ++depth)
+			{
+				chain = Exception{VAEXC_MSG("%s", longText.c_str()), _wrappers::ArgFunction(longText.c_str()), std::move(chain)};
+			}
+
+			size_t length = std::strlen(chain.what());
+
+			check(length <= (_control::MAX_INFO_SIZE + 15) * _control::MAX_EXC_COUNT, "what() stays within its buffer");
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace exception_bench;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--ms") == 0 && i + 1 < argc) minimumNs = std::strtoll(argv[++i], nullptr, 10) * 1000 * 1000;
+		else
+		{
+			std::printf("Usage: exception_bench [--ms MILLISECONDS]\n");
+			return 1;
+		}
+	}
+
+	std::printf("sizeof(VaExc::Exception) %zu, sizeof(std::runtime_error) %zu, sizeof(VaExc::Status) %zu\n",
+	            sizeof(Exception), sizeof(std::runtime_error), sizeof(Status));
+
+	std::printf("%-22s %-14s %12s\n", "case", "variant", "ns");
+
+	benchThrow();
+	benchCopyAndWhat();
+
+	std::printf("\ntruncation:\n");
+
+	checkTruncation();
+
+	return failedChecks == 0 ? 0 : 1;
+}
\ No newline at end of file
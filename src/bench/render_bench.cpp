@@ -0,0 +1,343 @@
+// Software renderer benchmark: every MySDL::Canvas primitive at several sizes on an offscreen
+// target, then whole frames the way the graphic renderer draws them. Needs no window or display.
+//
+// Build (from src/):
+//     g++ -std=c++17 -O2 -DNDEBUG bench/render_bench.cpp -o render_bench -lSDL2 -pthread
+// Run:
+//     ./render_bench [--threads N] [--ms MILLISECONDS]
+// --threads 1 (the default) measures a single core, 0 means a worker per hardware thread.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../SDL_support/MySDL_Offscreen.hpp"
+#include "../renderers/MorseGraphicRenderer.hpp"
+
+namespace render_bench
+{
+	using Clock = std::chrono::steady_clock;
+
+	const SDL_Color WHITE = {255, 255, 255, 255};
+	const SDL_Color BLACK = {  0,   0,   0, 255};
+
+	// Every case runs at least that long
+	long long minimumNs = 200 * 1000 * 1000;
+
+	// Calls batch() until the time is up, returns ns per call
+	template <typename Batch>
+	double measure(Batch&& batch)
+	{
+		// Warming up: caches, page faults, worker threads
+		batch();
+
+		long long calls = 0;
+
+		Clock::time_point start = Clock::now();
+		long long elapsed = 0;
+
+		do
+		{
+			batch();
+			++calls;
+
+			elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+		}
+		while (elapsed < minimumNs);
+
+		return static_cast<double>(elapsed) / calls;
+	}
+
+	// ns per primitive and pixels per second, batchNs for batchSize primitives of primitivePixels each
+	void report(const char* name, const std::string& size, double batchNs, size_t batchSize, double primitivePixels)
+	{
+		double nsPerPrimitive = batchNs / batchSize;
+		double pixelsPerSec   = primitivePixels * 1e9 / nsPerPrimitive;
+
+		std::printf("%-16s %-12s %14.1f %14.1f\n", name, size.c_str(), nsPerPrimitive, pixelsPerSec / 1e6);
+	}
+
+	std::string squareSize(unsigned side)
+	{
+		return std::to_string(side) + "x" + std::to_string(side);
+	}
+
+	// Endpoints and centers of a batch, generated up front so the generator isn't measured
+	struct Points
+	{
+		std::vector<int> x;
+		std::vector<int> y;
+
+		Points(size_t count, unsigned sizeX, unsigned sizeY, unsigned margin) :
+			x (count),
+			y (count)
+		{
+			std::mt19937 random{42};
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				x[i] = static_cast<int>(margin + random() % (sizeX - 2 * margin));
+				y[i] = static_cast<int>(margin + random() % (sizeY - 2 * margin));
+			}
+		}
+	};
+
+	const size_t BATCH = 1024;
+
+	void benchClear(MySDL::OffscreenRenderer& target)
+	{
+		for (unsigned side : {64u, 256u, 1024u})
+		{
+			target.startRendering({0, 0, static_cast<int>(side), static_cast<int>(side)});
+
+			double ns = measure([&] { target.clear(BLACK); });
+
+			target.finishRendering();
+
+			report("clear", squareSize(side), ns, 1, static_cast<double>(side) * side);
+		}
+	}
+
+	void benchPixel(MySDL::OffscreenRenderer& target)
+	{
+		Points points{BATCH, static_cast<unsigned>(target.getDestSizeX()), static_cast<unsigned>(target.getDestSizeY()), 0};
+
+		target.startRendering();
+
+		double ns = measure([&] { for (size_t i = 0; i < BATCH; ++i) target.pixel(points.x[i], points.y[i], WHITE); });
+
+		target.finishRendering();
+
+		report("pixel", "1x1", ns, BATCH, 1);
+	}
+
+	void benchLines(MySDL::OffscreenRenderer& target, bool smooth)
+	{
+		const char* name = smooth ? "smoothLine" : "line";
+
+		for (unsigned length : {16u, 128u, 1024u})
+		{
+			// Diagonal-ish lines of the given length along the major axis
+			Points points{BATCH, static_cast<unsigned>(target.getDestSizeX()) - length, static_cast<unsigned>(target.getDestSizeY()) - length, 0};
+
+			target.startRendering();
+
+			double ns = measure([&]
+			{
+				for (size_t i = 0; i < BATCH; ++i)
+				{
+					int x0 = points.x[i], y0 = points.y[i];
+					int x1 = x0 + static_cast<int>(length) - 1, y1 = y0 + static_cast<int>(length * (i % 7)) / 7;
+
+					if (smooth) target.smoothLine(x0, y0, x1, y1, WHITE);
+					else        target.line      (x0, y0, x1, y1, WHITE);
+				}
+			});
+
+			target.finishRendering();
+
+			report(name, std::to_string(length), ns, BATCH, length);
+		}
+	}
+
+	// kind: 0 circle, 1 round, 2 smoothCircle
+	void benchCircles(MySDL::OffscreenRenderer& target, int kind)
+	{
+		const char* names[] = {"circle", "round", "smoothCircle"};
+
+		for (unsigned r : {4u, 32u, 256u})
+		{
+			Points points{BATCH, static_cast<unsigned>(target.getDestSizeX()), static_cast<unsigned>(target.getDestSizeY()), r + 1};
+
+			target.startRendering();
+
+			double ns = measure([&]
+			{
+				for (size_t i = 0; i < BATCH; ++i)
+				{
+					if      (kind == 0) target.circle      (points.x[i], points.y[i], r, WHITE);
+					else if (kind == 1) target.round       (points.x[i], points.y[i], r, WHITE, BLACK);
+					else                target.smoothCircle(points.x[i], points.y[i], r, WHITE);
+				}
+			});
+
+			target.finishRendering();
+
+			// Pixels touched: the outline (about 2 * pi * r) or the whole disk
+			double pixels = kind == 1 ? 3.14159 * (r + 0.5) * (r + 0.5) : 2 * 3.14159 * r * (kind == 2 ? 2 : 1);
+
+			report(names[kind], "r" + std::to_string(r), ns, BATCH, pixels);
+		}
+	}
+
+	void benchShader(MySDL::OffscreenRenderer& target)
+	{
+		for (unsigned side : {64u, 256u, 1024u})
+		{
+			target.startRendering({0, 0, static_cast<int>(side), static_cast<int>(side)});
+
+			// A read-modify-write effect: darkening
+			double ns = measure([&]
+			{
+				target.applyShader(0, 0, side, side, [] (int, int, const SDL_Color& color) -> SDL_Color
+				{
+					return {static_cast<Uint8>(color.r * 7 / 8), static_cast<Uint8>(color.g * 7 / 8), static_cast<Uint8>(color.b * 7 / 8), color.a};
+				});
+			});
+
+			target.finishRendering();
+
+			report("applyShader", squareSize(side), ns, 1, static_cast<double>(side) * side);
+		}
+	}
+
+	// Whole frames of the graphic display: all tiles redrawn, then composed into the shown frame
+	void benchFrames(MySDL::ThreadPool* pool)
+	{
+		using namespace morse_graphic_renderer;
+
+		const char symbols[] = ".- <!";
+
+		MySDL::OffscreenRenderer target{SCREEN_W, SCREEN_H};
+		target.setThreadPool(pool);
+
+		TileLayout layout = TileLayout::fit(SCREEN_W, SCREEN_H);
+
+		// From primitives, as before the glyph atlas
+		{
+			MySDL::DrawList glyphs{static_cast<unsigned>(layout.side)};
+
+			for (size_t i = 0; i < layout.tileCount(); ++i)
+			{
+				int curX = static_cast<int>((i % layout.columns) * layout.side + layout.side / 2);
+				int curY = static_cast<int>((i / layout.columns) * layout.side + layout.side / 2);
+				int side = static_cast<int>(layout.side / 10);
+
+				switch (symbols[i % 5])
+				{
+					case '.': glyphs.circle(curX, curY, side, LINE_COLOR); break;
+					case '-': glyphs.rect(curX - 3 * side, curY - side, 6 * side + 1, 2 * side + 1, LINE_COLOR); break;
+					case ' ': glyphs.line(curX - 3 * side, curY + 3 * side, curX + 3 * side, curY + 3 * side, LINE_COLOR); break;
+					case '!':
+						glyphs.line(curX - 3 * side, curY - 3 * side, curX + 3 * side, curY + 3 * side, LINE_COLOR);
+						glyphs.line(curX - 3 * side, curY + 3 * side, curX + 3 * side, curY - 3 * side, LINE_COLOR);
+						break;
+					default: break;
+				}
+			}
+
+			double ns = measure([&]
+			{
+				target.startRendering();
+				target.clear(BACKGROUND_COLOR);
+				target.draw(glyphs);
+				target.finishRendering();
+				target.present();
+			});
+
+			report("frame/primitive", std::to_string(SCREEN_W) + "x" + std::to_string(SCREEN_H), ns, 1, static_cast<double>(SCREEN_W) * SCREEN_H);
+		}
+
+		// From the glyph atlas, what the renderer does after a resize
+		{
+			MorseGlyphAtlas atlas;
+			atlas.prepare(static_cast<unsigned>(layout.side), LINE_COLOR, BACKGROUND_COLOR, SMOOTH_GLYPHS);
+
+			double ns = measure([&]
+			{
+				target.startRendering();
+				target.clear(BACKGROUND_COLOR);
+
+				for (size_t i = 0; i < layout.tileCount(); ++i)
+				{
+					atlas.blit(target, symbols[i % 5], static_cast<int>((i % layout.columns) * layout.side), static_cast<int>((i / layout.columns) * layout.side));
+				}
+
+				target.finishRendering();
+				target.present();
+			});
+
+			report("frame/atlas", std::to_string(SCREEN_W) + "x" + std::to_string(SCREEN_H), ns, 1, static_cast<double>(SCREEN_W) * SCREEN_H);
+		}
+
+		// One symbol the way MorseGraphicsRender() draws it: a tile (or a row) redrawn; frames go nowhere
+		{
+			MorseGraphicRenderer renderer{"/dev/null"};
+			renderer.init();
+
+			MorseElement element = {'.', 1, MorseClock::time_point{}, MorseClock::time_point{}, MorseClock::time_point{}};
+			size_t       next    = 0;
+
+			double ns = measure([&]
+			{
+				element.symbol = symbols[next++ % 5];
+				renderer.render(element);
+			});
+
+			renderer.quit();
+
+			report("symbol", squareSize(static_cast<unsigned>(layout.side)), ns, 1, static_cast<double>(layout.side) * layout.side);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace render_bench;
+
+	size_t threads = 1;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if      (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads   = std::strtoul(argv[++i], nullptr, 10);
+		else if (std::strcmp(argv[i], "--ms"     ) == 0 && i + 1 < argc) minimumNs = std::strtoll(argv[++i], nullptr, 10) * 1000 * 1000;
+		else
+		{
+			std::printf("Usage: render_bench [--threads N] [--ms MILLISECONDS]\n");
+			return 1;
+		}
+	}
+
+	try
+	{
+		std::unique_ptr<MySDL::ThreadPool> pool;
+		if (threads != 1) pool.reset(new MySDL::ThreadPool{threads});
+
+		MySDL::OffscreenRenderer target{2048, 2048};
+		target.setThreadPool(pool.get());
+
+		target.startRendering();
+		target.clear(BLACK);
+		target.finishRendering();
+
+		std::printf("threads: %zu\n", pool ? pool->getThreadCount() : 1);
+		std::printf("%-16s %-12s %14s %14s\n", "primitive", "size", "ns/primitive", "Mpixels/s");
+
+		benchClear(target);
+		benchPixel(target);
+		benchLines(target, false);
+		benchLines(target, true);
+		benchCircles(target, 0);
+		benchCircles(target, 1);
+		benchCircles(target, 2);
+		benchShader(target);
+		benchFrames(pool.get());
+	}
+	catch (std::string& error)
+	{
+		std::printf("%s\n", error.c_str());
+		return 1;
+	}
+	catch (VaExc::Exception& exc)
+	{
+		std::printf("%s\n", exc.what());
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
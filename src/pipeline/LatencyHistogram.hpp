@@ -0,0 +1,145 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_LATENCY_HISTOGRAM_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_LATENCY_HISTOGRAM_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+namespace morse_pipeline
+{
+	// HDR-style histogram of latencies in microseconds: exact below 64 us, then 32 linear
+	// buckets per power of two, so every value is kept within ~3%. Recording is a couple of
+	// relaxed atomic increments, any thread can record and read at the same time.
+	class LatencyHistogram
+	{
+	private:
+		static const unsigned SUB_BUCKET_BITS  = 5;
+		static const uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+
+		// Values up to 2^36 us (19 hours), bigger ones go to the last bucket
+		static const unsigned MAX_SHIFT    = 36 - SUB_BUCKET_BITS - 1;
+		static const size_t   BUCKET_COUNT = (MAX_SHIFT + 2) * SUB_BUCKET_COUNT;
+
+		std::atomic<uint64_t> buckets_[BUCKET_COUNT];
+
+		std::atomic<uint64_t> count_;
+		std::atomic<uint64_t> sum_;
+		std::atomic<uint64_t> max_;
+
+		static unsigned highestBit(uint64_t value)
+		{
+			unsigned bit = 0;
+
+			while (value >>= 1) ++bit;
+
+			return bit;
+		}
+
+		static size_t bucketOf(uint64_t value)
+		{
+			unsigned bit   = highestBit(value);
+			unsigned shift = bit > SUB_BUCKET_BITS ? bit - SUB_BUCKET_BITS : 0;
+
+			if (shift > MAX_SHIFT) return BUCKET_COUNT - 1;
+
+			return shift * SUB_BUCKET_COUNT + (value >> shift);
+		}
+
+		// The smallest value of the bucket
+		static uint64_t bucketValue(size_t bucket)
+		{
+			if (bucket < 2 * SUB_BUCKET_COUNT) return bucket;
+
+			unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKET_COUNT - 1);
+
+			return (bucket - shift * SUB_BUCKET_COUNT) << shift;
+		}
+
+	public:
+		LatencyHistogram() :
+			count_ (0),
+			sum_   (0),
+			max_   (0)
+		{
+			for (std::atomic<uint64_t>& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+		}
+
+		LatencyHistogram           (const LatencyHistogram&) = delete;
+		LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+		// Negative latencies (an element rendered before its slot) count as 0
+		template <typename Duration>
+		void record(Duration latency)
+		{
+			long long micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+			uint64_t  value  = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+
+			buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+
+			count_.fetch_add(1,     std::memory_order_relaxed);
+			sum_  .fetch_add(value, std::memory_order_relaxed);
+
+			uint64_t max = max_.load(std::memory_order_relaxed);
+			while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+		}
+
+		uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+		uint64_t max()   const { return max_  .load(std::memory_order_relaxed); }
+
+		double mean() const
+		{
+			uint64_t count = this->count();
+
+			return count != 0 ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / count : 0;
+		}
+
+		// The value below which the fraction of samples lies (within the bucket precision), in microseconds
+		uint64_t percentile(double fraction) const
+		{
+			uint64_t count = this->count();
+			if (count == 0) return 0;
+
+			uint64_t wanted = static_cast<uint64_t>(fraction * count + 0.5);
+			if (wanted == 0) wanted = 1;
+
+			uint64_t seen = 0;
+
+			for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+			{
+				seen += buckets_[bucket].load(std::memory_order_relaxed);
+
+				if (seen >= wanted) return std::min(bucketValue(bucket), max());
+			}
+
+			return max();
+		}
+
+		// One line: count, mean and percentiles in milliseconds
+		void dump(std::ostream& out, const std::string& name) const
+		{
+			auto ms = [] (double micros) { return micros / 1000; };
+
+			out << std::left  << std::setw(20) << name
+			    << std::right << std::setw(9)  << count()
+			    << std::fixed << std::setprecision(2)
+			    << std::setw(10) << ms(mean())
+			    << std::setw(10) << ms(percentile(0.50))
+			    << std::setw(10) << ms(percentile(0.90))
+			    << std::setw(10) << ms(percentile(0.99))
+			    << std::setw(10) << ms(percentile(0.999))
+			    << std::setw(10) << ms(max()) << "\n";
+		}
+
+		static void dumpHeader(std::ostream& out)
+		{
+			out << "latency, ms              count      mean       p50       p90       p99     p99.9       max\n";
+		}
+	};
+
+}  // namespace morse_pipeline
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_LATENCY_HISTOGRAM_HPP_INCLUDED
\ No newline at end of file
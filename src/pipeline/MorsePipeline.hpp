@@ -0,0 +1,934 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_PIPELINE_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_PIPELINE_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "../queue/SpscQueue.hpp"
+#include "../queue/VaException.hpp"
+
+#include "../Morse.hpp"
+
+#include "../renderers/MorseRendererInterface.hpp"
+
+#include "../trace/Trace.hpp"
+
+#include "LatencyHistogram.hpp"
+
+// Stages, each running on its own thread:
+// reader -> encoder -> scheduler -> renderer (one or more)
+//
+// Stages are connected by bounded lock-free queues. The scheduler is the only
+// stage that waits for time slots, the broadcaster hands every timed element
+// to all renderers at once and renderers must not block.
+namespace morse_pipeline
+{
+	using Clock = MorseClock;
+
+	// Queue sizes:
+	const size_t CHAR_QUEUE_SIZE    = 4096;
+	const size_t SYMBOL_QUEUE_SIZE  = 1024;
+	const size_t ELEMENT_QUEUE_SIZE = 256;
+
+	const size_t INPUT_BLOCK_SIZE = 4096;
+	const int    INPUT_POLL_TIMEOUT = 100; // milliseconds
+
+	// Data between the stages carries the moments it went through the earlier stages, for latency histograms:
+	struct InputChar
+	{
+		char              value;
+		Clock::time_point input;
+	};
+
+	struct EncodedSymbol
+	{
+		MorseSymbol       symbol;
+		Clock::time_point input;
+		Clock::time_point encoded;
+	};
+
+	// The queues count their traffic, a few relaxed stores per batch
+	using CharQueue    = VaQueue::SpscQueue<InputChar,     CHAR_QUEUE_SIZE,    VaQueue::QueueMetrics>;
+	using SymbolQueue  = VaQueue::SpscQueue<EncodedSymbol, SYMBOL_QUEUE_SIZE,  VaQueue::QueueMetrics>;
+	using ElementQueue = VaQueue::SpscQueue<MorseElement,  ELEMENT_QUEUE_SIZE, VaQueue::QueueMetrics>;
+
+	// Waiting strategy for an empty or a full queue
+	class Backoff
+	{
+	private:
+		static const unsigned MAX_SPINS = 64;
+
+		unsigned spins_;
+
+	public:
+		Backoff() :
+			spins_ (0)
+		{}
+
+		void wait()
+		{
+			if (spins_ < MAX_SPINS)
+			{
+				++spins_;
+				std::this_thread::yield();
+			}
+			else
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		void reset() { spins_ = 0; }
+	};
+
+	// Counters of a stage:
+	struct StageStats
+	{
+		std::string name;
+		uint64_t    processed;     // Elements produced by the stage
+		uint64_t    dropped;       // Elements thrown away because the next stage is full
+		size_t      queueDepth;    // Elements waiting in the stage input queue
+		size_t      queueCapasity;
+		double      perSecond;     // Throughput since the start of the pipeline
+	};
+
+	// Counters of a queue between two stages:
+	struct QueueStats
+	{
+		std::string                   name;
+		VaQueue::QueueMetricsSnapshot metrics;
+		size_t                        depth;
+		size_t                        capasity;
+	};
+
+	template <typename Queue>
+	QueueStats queueStats(const std::string& name, const Queue& queue)
+	{
+		return {name, queue.metrics().snapshot(), queue.size(), queue.capasity()};
+	}
+
+	//-----------------------------------------------------------
+	// Stage base:
+	//-----------------------------------------------------------
+
+	class Stage
+	{
+	protected:
+		// Variables:
+			std::string name_;
+
+			std::atomic<uint64_t> processed_;
+			std::atomic<uint64_t> dropped_;
+
+			std::atomic<bool>& stopped_;
+			std::atomic<bool>  finished_;
+
+			std::string error_;
+			std::thread thread_;
+
+		// Stage cycle:
+			virtual void run() = 0;
+
+			// Called when the stage is done for any reason
+			virtual void closeOutput() = 0;
+
+			virtual size_t inputDepth()    const = 0;
+			virtual size_t inputCapasity() const = 0;
+
+	public:
+		// Ctor && dtor:
+			Stage(const std::string& name, std::atomic<bool>& stopped) :
+				name_      (name),
+				processed_ (0),
+				dropped_   (0),
+				stopped_   (stopped),
+				finished_  (false),
+				error_     (),
+				thread_    ()
+			{}
+
+			virtual ~Stage() { join(); }
+
+			Stage           (const Stage&) = delete;
+			Stage& operator=(const Stage&) = delete;
+
+		// Thread control:
+			void start()
+			{
+				thread_ = std::thread{[this] { runGuarded(); }};
+			}
+
+			void join()
+			{
+				if (thread_.joinable()) thread_.join();
+			}
+
+		// Getters:
+			const std::string& name()  const { return name_; }
+			const std::string& error() const { return error_; }
+
+			// The stage thread is done (or about to be)
+			bool finished() const { return finished_.load(); }
+
+			StageStats stats(double secondsRunning) const
+			{
+				uint64_t processed = processed_.load(std::memory_order_relaxed);
+
+				return
+				{
+					name_,
+					processed,
+					dropped_.load(std::memory_order_relaxed),
+					inputDepth(),
+					inputCapasity(),
+					secondsRunning > 0 ? processed / secondsRunning : 0
+				};
+			}
+
+	private:
+			void runGuarded()
+			{
+				MORSE_TRACE_THREAD(name_.c_str());
+
+				try
+				{
+					run();
+				}
+				catch (VaExc::Exception& exc)
+				{
+					error_ = exc.what();
+					stopped_.store(true);
+				}
+				catch (std::exception& exc)
+				{
+					error_ = exc.what();
+					stopped_.store(true);
+				}
+				catch (...)
+				{
+					error_ = "Unexpected exception";
+					stopped_.store(true);
+				}
+
+				closeOutput();
+
+				finished_.store(true);
+			}
+	};
+
+	//-----------------------------------------------------------
+	// Reader: file descriptor -> characters
+	//-----------------------------------------------------------
+
+	class ReaderStage : public Stage
+	{
+	private:
+		int         input_;
+		std::string prefix_;
+		CharQueue&  out_;
+
+		InputChar stamped_[INPUT_BLOCK_SIZE];
+
+		// Pushes the whole block, waiting for space if needed; all of it is stamped with the moment it was read
+		bool pushBlock(const char* block, size_t length)
+		{
+			MORSE_TRACE_SCOPE("reader push");
+
+			Backoff backoff;
+
+			Clock::time_point now = Clock::now();
+
+			for (size_t pushed = 0; pushed < length;)
+			{
+				size_t stampedLength = std::min(length - pushed, INPUT_BLOCK_SIZE);
+
+				for (size_t i = 0; i < stampedLength; ++i) stamped_[i] = {block[pushed + i], now};
+
+				size_t portion = out_.try_push_back(stamped_, stampedLength);
+
+				if (portion == 0)
+				{
+					if (stopped_.load(std::memory_order_relaxed)) return false;
+
+					backoff.wait();
+					continue;
+				}
+
+				backoff.reset();
+
+				pushed += portion;
+				processed_.fetch_add(portion, std::memory_order_relaxed);
+			}
+
+			return true;
+		}
+
+	protected:
+		void run() override
+		{
+			if (!pushBlock(prefix_.data(), prefix_.size())) return;
+
+			char block[INPUT_BLOCK_SIZE];
+
+			while (!stopped_.load(std::memory_order_relaxed))
+			{
+				// Polling with a timeout lets the stage notice a stopped pipeline
+				pollfd request = {input_, POLLIN, 0};
+
+				int ready = poll(&request, 1, INPUT_POLL_TIMEOUT);
+
+				if (ready < 0 && errno == EINTR) continue;
+				if (ready < 0)
+				{
+					throw VaExc::Exception(VAEXC_MSG("Reader: poll failed: %s", std::strerror(errno)), VAEXC_POS);
+				}
+				if (ready == 0) continue;
+
+				ssize_t got = read(input_, block, sizeof(block));
+
+				if (got < 0 && errno == EINTR) continue;
+				if (got <= 0) return;
+
+				// A raw terminal never reports EOF, so '\0' and Ctrl-D end the input there:
+				size_t length = static_cast<size_t>(got);
+				bool   ended  = false;
+
+				for (size_t i = 0; i < length; ++i)
+				{
+					if (block[i] == '\0' || block[i] == '\x04')
+					{
+						length = i;
+						ended  = true;
+					}
+				}
+
+				if (!pushBlock(block, length) || ended) return;
+			}
+		}
+
+		void closeOutput() override { out_.close(); }
+
+		size_t inputDepth()    const override { return 0; }
+		size_t inputCapasity() const override { return 0; }
+
+	public:
+		ReaderStage(std::atomic<bool>& stopped, int input, const char* prefix, CharQueue& out) :
+			Stage   ("reader", stopped),
+			input_   (input),
+			prefix_  (prefix),
+			out_     (out),
+			stamped_ ()
+		{}
+	};
+
+	//-----------------------------------------------------------
+	// Encoder: characters -> morse symbols
+	//-----------------------------------------------------------
+
+	class EncoderStage : public Stage
+	{
+	private:
+		// Longest code, its in-letter spaces and a letter space
+		static const size_t MAX_SYMBOLS_PER_CHAR = 16;
+
+		static const size_t CHARS_PER_POP = 256;
+
+		CharQueue&   in_;
+		SymbolQueue& out_;
+
+		// From reading to encoding: the time a character waits in the queue
+		LatencyHistogram& queued_;
+
+	protected:
+		void run() override
+		{
+			MorseEncoder encoder{};
+			Backoff backoff;
+
+			InputChar chars[CHARS_PER_POP];
+
+			while (!stopped_.load(std::memory_order_relaxed))
+			{
+				size_t popped = in_.try_pop_front(chars, CHARS_PER_POP);
+
+				if (popped == 0)
+				{
+					if (in_.finished()) return;
+
+					backoff.wait();
+					continue;
+				}
+
+				backoff.reset();
+
+				MORSE_TRACE_SCOPE("encode batch");
+				MORSE_TRACE_COUNTER("chars queued", in_.size());
+
+				// Characters popped together are encoded at the same moment
+				Clock::time_point encoded = Clock::now();
+
+				for (size_t i = 0; i < popped; ++i)
+				{
+					queued_.record(encoded - chars[i].input);
+
+					EncodedSymbol symbols[MAX_SYMBOLS_PER_CHAR];
+					size_t count = 0;
+
+					{
+						MORSE_TRACE_SCOPE("morseFromChar");
+
+						encoder.encode(chars[i].value, [&symbols, &count, &chars, i, encoded] (MorseSymbol symbol)
+						{
+							symbols[count++] = {symbol, chars[i].input, encoded};
+						});
+					}
+
+					for (size_t pushed = 0; pushed < count;)
+					{
+						size_t portion = out_.try_push_back(symbols + pushed, count - pushed);
+
+						if (portion == 0)
+						{
+							if (stopped_.load(std::memory_order_relaxed)) return;
+
+							backoff.wait();
+							continue;
+						}
+
+						pushed += portion;
+						processed_.fetch_add(portion, std::memory_order_relaxed);
+					}
+
+					backoff.reset();
+				}
+			}
+		}
+
+		void closeOutput() override { out_.close(); }
+
+		size_t inputDepth()    const override { return in_.size(); }
+		size_t inputCapasity() const override { return in_.capasity(); }
+
+	public:
+		EncoderStage(std::atomic<bool>& stopped, CharQueue& in, SymbolQueue& out, LatencyHistogram& queued) :
+			Stage   ("encoder", stopped),
+			in_     (in),
+			out_    (out),
+			queued_ (queued)
+		{}
+	};
+
+	//-----------------------------------------------------------
+	// Renderer: timed elements -> output
+	//-----------------------------------------------------------
+
+	class RenderStage : public Stage
+	{
+	private:
+		ElementQueue in_;
+
+		std::unique_ptr<MorseRendererInterface> renderer_;
+
+		// Real time drops elements when the renderer is behind, virtual time waits for it
+		const bool realTime_;
+
+		// From the slot start to the end of render(): scheduling jitter plus the renderer's own lag
+		LatencyHistogram late_;
+		// From reading the character to the end of render()
+		LatencyHistogram endToEnd_;
+
+		// Till the input ends or the pipeline stops
+		void renderAll()
+		{
+			Backoff backoff;
+			MorseElement element{};
+
+			while (!stopped_.load(std::memory_order_relaxed))
+			{
+				if (!in_.try_pop_front(element))
+				{
+					if (in_.finished()) break;
+
+					renderer_->idle();
+
+					backoff.wait();
+					continue;
+				}
+
+				backoff.reset();
+
+				// Everything queued so far makes one frame; bounded, so a fast producer can't hold the frame forever
+				size_t batch = 0;
+
+				do
+				{
+					{
+						MORSE_TRACE_SCOPE("render");
+
+						// The stage is where a bad element becomes an exception, the renderer only reports it
+						VaExc::Status status = renderer_->tryRender(element);
+						if (!status.ok()) status.raise();
+					}
+
+					Clock::time_point rendered = Clock::now();
+
+					late_.record(rendered - element.start);
+					if (element.input != Clock::time_point{}) endToEnd_.record(rendered - element.input);
+
+					processed_.fetch_add(1, std::memory_order_relaxed);
+				}
+				while (++batch < in_.capasity() && in_.try_pop_front(element));
+
+				MORSE_TRACE_SCOPE("present");
+
+				renderer_->present();
+			}
+		}
+
+	protected:
+		// quit() runs on this thread whatever happens: the renderer's SDL objects have to be gone before main() quits SDL
+		void run() override
+		{
+			try
+			{
+				renderer_->init();
+
+				renderAll();
+			}
+			catch (...)
+			{
+				// The first error is the one reported
+				try { renderer_->quit(); } catch (...) {}
+
+				throw;
+			}
+
+			renderer_->quit();
+		}
+
+		void closeOutput() override {}
+
+		size_t inputDepth()    const override { return in_.size(); }
+		size_t inputCapasity() const override { return in_.capasity(); }
+
+	public:
+		RenderStage(std::atomic<bool>& stopped, const std::string& name, std::unique_ptr<MorseRendererInterface> renderer, bool realTime) :
+			Stage     (name, stopped),
+			in_       (),
+			renderer_ (std::move(renderer)),
+			realTime_ (realTime),
+			late_     (),
+			endToEnd_ ()
+		{}
+
+		const ElementQueue& input() const { return in_; }
+
+		const LatencyHistogram& late()     const { return late_; }
+		const LatencyHistogram& endToEnd() const { return endToEnd_; }
+
+		// In real time never blocks: a renderer that can't keep up loses elements, not the pipeline
+		void offer(const MorseElement& element)
+		{
+			if (realTime_)
+			{
+				if (!in_.try_push_back(element)) dropped_.fetch_add(1, std::memory_order_relaxed);
+
+				return;
+			}
+
+			Backoff backoff;
+
+			while (!in_.try_push_back(element))
+			{
+				if (stopped_.load(std::memory_order_relaxed)) return;
+
+				backoff.wait();
+			}
+		}
+
+		void closeInput() { in_.close(); }
+	};
+
+	//-----------------------------------------------------------
+	// Broadcaster: one timed stream -> every renderer
+	//-----------------------------------------------------------
+
+	class Broadcaster
+	{
+	private:
+		std::vector<std::unique_ptr<RenderStage>> stages_;
+
+	public:
+		void add(std::unique_ptr<RenderStage> stage) { stages_.push_back(std::move(stage)); }
+
+		// All renderers get the element at the same moment, none of them can hold the others
+		void broadcast(const MorseElement& element)
+		{
+			for (auto& stage : stages_) stage->offer(element);
+		}
+
+		void close()
+		{
+			for (auto& stage : stages_) stage->closeInput();
+		}
+
+		void start()
+		{
+			for (auto& stage : stages_) stage->start();
+		}
+
+		void join()
+		{
+			for (auto& stage : stages_) stage->join();
+		}
+
+		const std::vector<std::unique_ptr<RenderStage>>& stages() const { return stages_; }
+	};
+
+	//-----------------------------------------------------------
+	// Scheduler: morse symbols -> timed elements for every renderer
+	//-----------------------------------------------------------
+
+	class SchedulerStage : public Stage
+	{
+	private:
+		SymbolQueue& in_;
+
+		Broadcaster& broadcaster_;
+
+		// Virtual time: elements get their times, but nobody waits for them
+		const bool realTime_;
+
+		// From encoding to the slot start: how far ahead of time symbols are encoded
+		LatencyHistogram& scheduled_;
+
+	protected:
+		void run() override
+		{
+			Backoff backoff;
+			Clock::time_point nextSlot = Clock::now();
+
+			while (!stopped_.load(std::memory_order_relaxed))
+			{
+				EncodedSymbol symbol = {};
+
+				if (!in_.try_pop_front(symbol))
+				{
+					if (in_.finished()) break;
+
+					backoff.wait();
+					continue;
+				}
+
+				backoff.reset();
+
+				MORSE_TRACE_COUNTER("symbols queued", in_.size());
+
+				// After a pause the schedule starts over from now
+				if (realTime_)
+				{
+					Clock::time_point now = Clock::now();
+					if (nextSlot < now) nextSlot = now;
+				}
+
+				MorseElement element = {symbol.symbol, morseSymbolUnits(symbol.symbol), nextSlot, symbol.input, symbol.encoded};
+
+				scheduled_.record(element.start - element.encoded);
+
+				if (realTime_)
+				{
+					MORSE_TRACE_SCOPE("wait for slot");
+
+					std::this_thread::sleep_until(element.start);
+				}
+
+				{
+					MORSE_TRACE_SCOPE("broadcast");
+
+					broadcaster_.broadcast(element);
+				}
+
+				processed_.fetch_add(1, std::memory_order_relaxed);
+
+				nextSlot += std::chrono::milliseconds(element.units * MORSE_TIME_UNIT);
+			}
+
+			// The last element owns its slot till the end
+			if (realTime_) std::this_thread::sleep_until(nextSlot);
+		}
+
+		void closeOutput() override { broadcaster_.close(); }
+
+		size_t inputDepth()    const override { return in_.size(); }
+		size_t inputCapasity() const override { return in_.capasity(); }
+
+	public:
+		SchedulerStage(std::atomic<bool>& stopped, SymbolQueue& in, Broadcaster& broadcaster, bool realTime, LatencyHistogram& scheduled) :
+			Stage        ("scheduler", stopped),
+			in_          (in),
+			broadcaster_ (broadcaster),
+			realTime_    (realTime),
+			scheduled_   (scheduled)
+		{}
+	};
+
+	//-----------------------------------------------------------
+	// The pipeline itself:
+	//-----------------------------------------------------------
+
+	class MorsePipeline
+	{
+	private:
+		// Variables:
+			std::atomic<bool> stopped_;
+
+			LatencyHistogram queued_;
+			LatencyHistogram scheduled_;
+
+			CharQueue   chars_;
+			SymbolQueue symbols_;
+
+			Broadcaster broadcaster_;
+
+			ReaderStage    reader_;
+			EncoderStage   encoder_;
+			SchedulerStage scheduler_;
+
+			Clock::time_point started_;
+
+			const bool realTime_;
+
+	public:
+		// Ctor && dtor:
+			// Without real time the elements keep their times, but everything runs as fast as the renderers can go
+			MorsePipeline(int input, const char* prefix, bool realTime = true) :
+				stopped_     (false),
+				queued_      (),
+				scheduled_   (),
+				chars_       (),
+				symbols_     (),
+				broadcaster_ (),
+				reader_      (stopped_, input, prefix, chars_),
+				encoder_     (stopped_, chars_, symbols_, queued_),
+				scheduler_   (stopped_, symbols_, broadcaster_, realTime, scheduled_),
+				started_     (),
+				realTime_    (realTime)
+			{}
+
+			~MorsePipeline()
+			{
+				stopped_.store(true);
+
+				join();
+			}
+
+			MorsePipeline           (const MorsePipeline&) = delete;
+			MorsePipeline& operator=(const MorsePipeline&) = delete;
+
+		// Setup, has to be done before start():
+			MorsePipeline& addRenderer(const std::string& name, std::unique_ptr<MorseRendererInterface> renderer)
+			{
+				broadcaster_.add(std::unique_ptr<RenderStage>{new RenderStage{stopped_, name, std::move(renderer), realTime_}});
+
+				return *this;
+			}
+
+		// Thread control:
+			void start()
+			{
+				started_ = Clock::now();
+
+				broadcaster_.start();
+
+				scheduler_.start();
+				encoder_  .start();
+				reader_   .start();
+			}
+
+			void join()
+			{
+				reader_   .join();
+				encoder_  .join();
+				scheduler_.join();
+
+				broadcaster_.join();
+			}
+
+		// Getters:
+			// All the stages are done
+			bool finished() const
+			{
+				if (!scheduler_.finished()) return false;
+
+				for (auto& stage : broadcaster_.stages())
+				{
+					if (!stage->finished()) return false;
+				}
+
+				return true;
+			}
+
+			std::vector<StageStats> stats() const
+			{
+				double seconds = std::chrono::duration<double>(Clock::now() - started_).count();
+
+				std::vector<StageStats> result =
+				{
+					reader_   .stats(seconds),
+					encoder_  .stats(seconds),
+					scheduler_.stats(seconds)
+				};
+
+				for (auto& stage : broadcaster_.stages()) result.push_back(stage->stats(seconds));
+
+				return result;
+			}
+
+			// Safe to call while the pipeline runs
+			std::vector<QueueStats> queueStats() const
+			{
+				std::vector<QueueStats> result =
+				{
+					morse_pipeline::queueStats("chars",   chars_),
+					morse_pipeline::queueStats("symbols", symbols_)
+				};
+
+				for (auto& stage : broadcaster_.stages())
+				{
+					result.push_back(morse_pipeline::queueStats("elements:" + stage->name(), stage->input()));
+				}
+
+				return result;
+			}
+
+			std::vector<std::string> errors() const
+			{
+				std::vector<std::string> result;
+
+				if (!reader_   .error().empty()) result.push_back(reader_   .error());
+				if (!encoder_  .error().empty()) result.push_back(encoder_  .error());
+				if (!scheduler_.error().empty()) result.push_back(scheduler_.error());
+
+				for (auto& stage : broadcaster_.stages())
+				{
+					if (!stage->error().empty()) result.push_back(stage->error());
+				}
+
+				return result;
+			}
+
+		// Debugging:
+			void dumpStats(std::ostream& out) const
+			{
+				out << "stage       processed  dropped  queue        per second\n";
+
+				for (const StageStats& stage : stats())
+				{
+					out << std::left  << std::setw(10) << stage.name
+					    << std::right << std::setw(11) << stage.processed
+					    << std::setw(9) << stage.dropped
+					    << std::setw(7) << stage.queueDepth << "/" << std::left << std::setw(6) << stage.queueCapasity
+					    << std::right << std::setw(10) << std::fixed << std::setprecision(1) << stage.perSecond << "\n";
+				}
+
+				out << "queue                  pushes      pops  high water  overflows  underflows  full, s  empty, s\n";
+
+				for (const QueueStats& queue : queueStats())
+				{
+					out << std::left  << std::setw(18) << queue.name
+					    << std::right << std::setw(11) << queue.metrics.pushes
+					    << std::setw(10) << queue.metrics.pops
+					    << std::setw(7)  << queue.metrics.highWater << "/" << std::left << std::setw(5) << queue.capasity
+					    << std::right << std::setw(10) << queue.metrics.overflows
+					    << std::setw(12) << queue.metrics.underflows
+					    << std::fixed << std::setprecision(2)
+					    << std::setw(9)  << queue.metrics.secondsFull
+					    << std::setw(10) << queue.metrics.secondsEmpty << "\n";
+				}
+			}
+
+			// Prometheus text exposition format, for a textfile collector or a look by hand; safe to call while the pipeline runs
+			void writeMetrics(std::ostream& out) const
+			{
+				std::vector<StageStats> stages = stats();
+				std::vector<QueueStats> queues = queueStats();
+
+				auto family = [&out] (const char* name, const char* type, const char* help)
+				{
+					out << "# HELP " << name << " " << help << "\n"
+					    << "# TYPE " << name << " " << type << "\n";
+				};
+
+				auto stageFamily = [&] (const char* name, const char* type, const char* help, uint64_t StageStats::* field)
+				{
+					family(name, type, help);
+
+					for (const StageStats& stage : stages) out << name << "{stage=\"" << stage.name << "\"} " << stage.*field << "\n";
+				};
+
+				auto queueFamily = [&] (const char* name, const char* type, const char* help, auto value)
+				{
+					family(name, type, help);
+
+					for (const QueueStats& queue : queues) out << name << "{queue=\"" << queue.name << "\"} " << value(queue) << "\n";
+				};
+
+				out << std::fixed << std::setprecision(6);
+
+				stageFamily("morse_stage_processed_total", "counter", "Elements produced by the stage.",                   &StageStats::processed);
+				stageFamily("morse_stage_dropped_total",   "counter", "Elements thrown away because the next stage is full.", &StageStats::dropped);
+
+				queueFamily("morse_queue_pushes_total",     "counter", "Elements pushed into the queue.",
+				            [] (const QueueStats& queue) { return queue.metrics.pushes; });
+				queueFamily("morse_queue_pops_total",       "counter", "Elements popped from the queue.",
+				            [] (const QueueStats& queue) { return queue.metrics.pops; });
+				queueFamily("morse_queue_depth",            "gauge",   "Elements waiting in the queue.",
+				            [] (const QueueStats& queue) { return queue.depth; });
+				queueFamily("morse_queue_capacity",         "gauge",   "Elements the queue can hold.",
+				            [] (const QueueStats& queue) { return queue.capasity; });
+				queueFamily("morse_queue_high_water",       "gauge",   "The deepest the queue has been.",
+				            [] (const QueueStats& queue) { return queue.metrics.highWater; });
+				queueFamily("morse_queue_overflows_total",  "counter", "Times the queue got full; retries while it stays full count once.",
+				            [] (const QueueStats& queue) { return queue.metrics.overflows; });
+				queueFamily("morse_queue_underflows_total", "counter", "Times the queue got empty; polls while it stays empty count once.",
+				            [] (const QueueStats& queue) { return queue.metrics.underflows; });
+				queueFamily("morse_queue_full_seconds_total",  "counter", "Time the producer waited for space.",
+				            [] (const QueueStats& queue) { return queue.metrics.secondsFull; });
+				queueFamily("morse_queue_empty_seconds_total", "counter", "Time the consumer waited for elements.",
+				            [] (const QueueStats& queue) { return queue.metrics.secondsEmpty; });
+			}
+
+			// Safe to call while the pipeline runs
+			void dumpLatency(std::ostream& out) const
+			{
+				LatencyHistogram::dumpHeader(out);
+
+				queued_   .dump(out, "input -> encoded");
+				scheduled_.dump(out, "encoded -> slot");
+
+				for (auto& stage : broadcaster_.stages())
+				{
+					stage->late()    .dump(out, "slot -> " + stage->name());
+					stage->endToEnd().dump(out, "input -> " + stage->name());
+				}
+			}
+	};
+
+}  // namespace morse_pipeline
+
+using morse_pipeline::MorsePipeline;
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_PIPELINE_HPP_INCLUDED
\ No newline at end of file
@@ -133,8 +133,17 @@ namespace VaQueue
 				PolymorphicCore<Data_t, capasity_>&
 				PolymorphicCore<Data_t, capasity_>::operator=(const PolymorphicCore<Data_t, capasity_>& that)
 				{
-					this->~PolymorphicCore();
-					this->PolymorphicCore(that);
+					if (this == &that) return *this;
+
+					for (size_t i = 0; i < capasity_; ++i)
+					{
+						delete buf_[i];
+
+						if (that.buf_[i] == nullptr) buf_[i] = nullptr;
+						else buf_[i] = new Data_t(*that.buf_[i]);
+					}
+
+					return *this;
 				}
 
 			// Functions on elements:
@@ -143,7 +152,7 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					if (buf_[index] != nullptr)
@@ -161,7 +170,7 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					if (buf_[index] != nullptr)
@@ -179,12 +188,12 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					if (buf_[index] == nullptr)
 					{
-						throw Exception(ArgMsg("No element by index: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("No element by index: %zu", index), VAEXC_POS);
 					}
 
 					return buf_[index];
@@ -195,12 +204,12 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					if (buf_[index] == nullptr)
 					{
-						throw Exception(ArgMsg("No element by index: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("No element by index: %zu", index), VAEXC_POS);
 					}
 
 					Data_t* toReturn = buf_[index];
@@ -217,7 +226,7 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					buf_[index] = data;
@@ -228,7 +237,7 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					buf_[index] = data;
@@ -239,7 +248,7 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					return buf_[index];
@@ -250,7 +259,7 @@ namespace VaQueue
 				{
 					if (index >= capasity_)
 					{
-						throw Exception(ArgMsg("Index out of bounds: %zu", index), VAEXC_POS);
+						throw Exception(VAEXC_MSG("Index out of bounds: %zu", index), VAEXC_POS);
 					}
 
 					return std::move(buf_[index]);
@@ -306,19 +315,31 @@ namespace VaQueue
 				Queue& operator=(Queue&&) = default;
 
 
-			// Functions on elements:
+			// Functions on elements, throwing Exception:
 				Queue& push_back(const Data_t& );
 				Queue& push_back(      Data_t&&);
+				Queue& push_back(const Data_t* data, size_t count);
 
 				Data_t&& pop_front();
 
 				Data_t& at(size_t index);
 
+			// Functions on elements, returning Status (nothing is formatted or thrown on errors):
+				Status try_push_back(const Data_t& );
+				Status try_push_back(      Data_t&&);
+				Status try_push_back(const Data_t* data, size_t count);
+
+				Status try_pop_front(Data_t& data);
+
+				Expected<Data_t*> try_at(size_t index);
+
 				inline size_t capasity() const { return capasity_; }
 
 				inline size_t size() const { return end_ - beg_; }
 
 			// Assertion:
+				inline Status check() const;
+
 				inline void throwIfNotOk() const;
 		};
 
@@ -353,87 +374,164 @@ namespace VaQueue
 					throwIfNotOk();
 				}
 
-			// Functions on elements:
+			// Functions on elements, throwing Exception:
 				template <typename Data_t, size_t capasity_>
 				Queue<Data_t, capasity_>& Queue<Data_t, capasity_>::push_back(const Data_t& data)
+				{
+					try_push_back(data).raiseIfFailed();
+
+					return *this;
+				}
+
+				template <typename Data_t, size_t capasity_>
+				Queue<Data_t, capasity_>& Queue<Data_t, capasity_>::push_back(Data_t&& data)
+				{
+					try_push_back(std::move(data)).raiseIfFailed();
+
+					return *this;
+				}
+
+				template <typename Data_t, size_t capasity_>
+				Queue<Data_t, capasity_>& Queue<Data_t, capasity_>::push_back(const Data_t* data, size_t count)
+				{
+					try_push_back(data, count).raiseIfFailed();
+
+					return *this;
+				}
+
+				template <typename Data_t, size_t capasity_>
+				Data_t&& Queue<Data_t, capasity_>::pop_front()
 				{
 					throwIfNotOk();
 
+					if (end_ == beg_)
+					{
+						throw Exception("Can't pop from empty Queue"_msg, VAEXC_POS);
+					}
+
+					size_t toDelete = beg_;
+
+					// Fixing beg_ and end_:
+					size_t newSize = end_ - beg_ - 1;
+					beg_ = (beg_ + 1) % capasity_;
+					end_ = beg_ + newSize;
+
+					return Ancestor::remove(toDelete);
+				}
+
+				template <typename Data_t, size_t capasity_>
+				Data_t& Queue<Data_t, capasity_>::at(size_t index)
+				{
+					return *try_at(index).value();
+				}
+
+			// Functions on elements, returning Status:
+				template <typename Data_t, size_t capasity_>
+				Status Queue<Data_t, capasity_>::try_push_back(const Data_t& data)
+				{
+					Status status = check();
+					if (!status.ok()) return status;
+
 					if (end_ - beg_ == capasity_)
 					{
-						throw Exception("Queue overflow"_msg, VAEXC_POS);
+						return VAEXC_STATUS(Errc::Overflow, "Queue overflow");
 					}
 
 					Ancestor::insert(end_ % capasity_, data);
 
 					++end_;
 
-					return *this;
+					return {};
 				}
 
 				template <typename Data_t, size_t capasity_>
-				Queue<Data_t, capasity_>& Queue<Data_t, capasity_>::push_back(Data_t&& data)
+				Status Queue<Data_t, capasity_>::try_push_back(Data_t&& data)
 				{
-					throwIfNotOk();
+					Status status = check();
+					if (!status.ok()) return status;
 
 					if (end_ - beg_ == capasity_)
 					{
-						throw Exception("Queue overflow"_msg, VAEXC_POS);
+						return VAEXC_STATUS(Errc::Overflow, "Queue overflow");
 					}
 
 					Ancestor::insert(end_ % capasity_, std::move(data));
 
 					++end_;
 
-					return *this;
+					return {};
 				}
 
 				template <typename Data_t, size_t capasity_>
-				Data_t&& Queue<Data_t, capasity_>::pop_front()
+				Status Queue<Data_t, capasity_>::try_push_back(const Data_t* data, size_t count)
 				{
-					throwIfNotOk();
+					Status status = check();
+					if (!status.ok()) return status;
 
-					if (end_ == beg_)
+					if (count > capasity_ - (end_ - beg_))
 					{
-						throw Exception("Can't pop from empty Queue"_msg, VAEXC_POS);
+						return VAEXC_STATUS(Errc::Overflow, "Queue overflow: can't push %lld elements", count);
 					}
 
-					size_t toDelete = beg_;
+					for (size_t i = 0; i < count; ++i, ++end_)
+					{
+						Ancestor::insert(end_ % capasity_, data[i]);
+					}
 
-					// Fixing beg_ and end_:
-					size_t newSize = end_ - beg_ - 1;
-					beg_ = (beg_ + 1) % capasity_;
-					end_ = beg_ + newSize;
+					return {};
+				}
 
-					return Ancestor::remove(toDelete);
+				template <typename Data_t, size_t capasity_>
+				Status Queue<Data_t, capasity_>::try_pop_front(Data_t& data)
+				{
+					Status status = check();
+					if (!status.ok()) return status;
+
+					if (end_ == beg_)
+					{
+						return VAEXC_STATUS(Errc::Empty, "Can't pop from empty Queue");
+					}
+
+					data = pop_front();
+
+					return {};
 				}
 
 				template <typename Data_t, size_t capasity_>
-				Data_t& Queue<Data_t, capasity_>::at(size_t index)
+				Expected<Data_t*> Queue<Data_t, capasity_>::try_at(size_t index)
 				{
-					throwIfNotOk();
+					Status status = check();
+					if (!status.ok()) return status;
 
 					if (index >= end_ - beg_)
 					{
-						throw Exception("Access out of bounds"_msg, VAEXC_POS);
+						return VAEXC_STATUS(Errc::OutOfBounds, "Access out of bounds: %lld", index);
 					}
 
-					return Ancestor::get((beg_ + index) % capasity_);
+					return &Ancestor::get((beg_ + index) % capasity_);
 				}
 
 			// Assertion:
 				template <typename Data_t, size_t capasity_>
-				inline void Queue<Data_t, capasity_>::throwIfNotOk() const
+				inline Status Queue<Data_t, capasity_>::check() const
 				{
 					if (beg_ >= capasity_)
 					{
-						throw Exception("Queue: beg_ variable is not OK"_msg, VAEXC_POS);
+						return VAEXC_STATUS(Errc::BrokenState, "Queue: beg_ variable is not OK");
 					}
 
 					if (end_ < beg_ || end_ > beg_ + capasity_)
 					{
-						throw Exception("Queue: end_ variable is not OK"_msg, VAEXC_POS);
+						return VAEXC_STATUS(Errc::BrokenState, "Queue: end_ variable is not OK");
 					}
+
+					return {};
+				}
+
+				template <typename Data_t, size_t capasity_>
+				inline void Queue<Data_t, capasity_>::throwIfNotOk() const
+				{
+					check().raiseIfFailed();
 				}
 
 	} // namespace _queue
@@ -0,0 +1,149 @@
+#ifndef HEADER_GUARD_VA_QUEUE_METRICS_INCLUDED
+#define HEADER_GUARD_VA_QUEUE_METRICS_INCLUDED "QueueMetrics.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Metrics policies for SpscQueue: NoQueueMetrics costs nothing, QueueMetrics counts
+// traffic and the time each side spends waiting. A policy gets called by the queue:
+//     onPush(pushed, requested, depthAfterPush) - on the producer thread
+//     onPop (popped, requested)                 - on the consumer thread
+namespace VaQueue
+{
+	// Everything counted so far, readable from any thread
+	struct QueueMetricsSnapshot
+	{
+		uint64_t pushes;       // Elements pushed
+		uint64_t pops;         // Elements popped
+		uint64_t highWater;    // The deepest the queue has been
+		uint64_t overflows;    // Times the queue got full: retries while it stays full count once
+		uint64_t underflows;   // Times the queue got empty: polls while it stays empty count once
+		double   secondsFull;  // The producer waiting for space
+		double   secondsEmpty; // The consumer waiting for elements
+	};
+
+	struct NoQueueMetrics
+	{
+		inline void onPush(size_t, size_t, size_t) {}
+		inline void onPop (size_t, size_t)         {}
+	};
+
+	class QueueMetrics
+	{
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		// Every counter has one writer, so it is a relaxed load and store, not a locked add.
+		// Producer side:
+			std::atomic<uint64_t> pushes_;
+			std::atomic<uint64_t> highWater_;
+			std::atomic<uint64_t> overflows_;
+			std::atomic<int64_t>  fullNs_;
+			std::atomic<int64_t>  fullSince_;  // 0 while the queue has space
+
+		// Consumer side:
+			alignas(64) std::atomic<uint64_t> pops_;
+			std::atomic<uint64_t> underflows_;
+			std::atomic<int64_t>  emptyNs_;
+			std::atomic<int64_t>  emptySince_; // 0 while the queue has elements
+
+		static int64_t now()
+		{
+			// Never 0, that is "not waiting"
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count() | 1;
+		}
+
+		static void add(std::atomic<uint64_t>& counter, uint64_t value)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		static void add(std::atomic<int64_t>& counter, int64_t value)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		// Starts or ends a waiting interval, the clock is read only on these changes.
+		// Returns true if a new interval has started.
+		static bool wait(bool waiting, std::atomic<int64_t>& since, std::atomic<int64_t>& total)
+		{
+			int64_t started = since.load(std::memory_order_relaxed);
+
+			if (waiting && started == 0)
+			{
+				since.store(now(), std::memory_order_relaxed);
+
+				return true;
+			}
+			else if (!waiting && started != 0)
+			{
+				add(total, now() - started);
+				since.store(0, std::memory_order_relaxed);
+			}
+
+			return false;
+		}
+
+		static double seconds(const std::atomic<int64_t>& total, const std::atomic<int64_t>& since, int64_t moment)
+		{
+			int64_t started = since.load(std::memory_order_relaxed);
+			int64_t ns      = total.load(std::memory_order_relaxed) + (started != 0 && moment > started ? moment - started : 0);
+
+			return ns / 1e9;
+		}
+
+	public:
+		QueueMetrics() :
+			pushes_     (0),
+			highWater_  (0),
+			overflows_  (0),
+			fullNs_     (0),
+			fullSince_  (0),
+			pops_       (0),
+			underflows_ (0),
+			emptyNs_    (0),
+			emptySince_ (0)
+		{}
+
+		QueueMetrics           (const QueueMetrics&) = delete;
+		QueueMetrics& operator=(const QueueMetrics&) = delete;
+
+		void onPush(size_t pushed, size_t requested, size_t depth)
+		{
+			add(pushes_, pushed);
+
+			if (depth > highWater_.load(std::memory_order_relaxed)) highWater_.store(depth, std::memory_order_relaxed);
+
+			if (wait(pushed < requested, fullSince_, fullNs_)) add(overflows_, 1);
+		}
+
+		void onPop(size_t popped, size_t requested)
+		{
+			add(pops_, popped);
+
+			if (wait(popped == 0 && requested != 0, emptySince_, emptyNs_)) add(underflows_, 1);
+		}
+
+		// Waiting intervals still going on are counted up to now
+		QueueMetricsSnapshot snapshot() const
+		{
+			int64_t moment = now();
+
+			return
+			{
+				pushes_    .load(std::memory_order_relaxed),
+				pops_      .load(std::memory_order_relaxed),
+				highWater_ .load(std::memory_order_relaxed),
+				overflows_ .load(std::memory_order_relaxed),
+				underflows_.load(std::memory_order_relaxed),
+				seconds(fullNs_,  fullSince_,  moment),
+				seconds(emptyNs_, emptySince_, moment)
+			};
+		}
+	};
+
+}
+
+#endif /* HEADER_GUARD_VA_QUEUE_METRICS_INCLUDED */
\ No newline at end of file
@@ -0,0 +1,165 @@
+#ifndef HEADER_GUARD_VA_SPSC_QUEUE_INCLUDED
+#define HEADER_GUARD_VA_SPSC_QUEUE_INCLUDED "SpscQueue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "QueueMetrics.hpp"
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+// Implemented via circular buffer with free-running indices.
+// Metrics_t counts the traffic, see QueueMetrics.hpp; the default counts nothing.
+namespace VaQueue
+{
+	namespace _spsc_queue
+	{
+		template <typename Data_t, size_t capasity_, typename Metrics_t = NoQueueMetrics>
+		class SpscQueue
+		{
+		private:
+			// Cache line size, keeps producer and consumer indices apart
+			static constexpr size_t CACHE_LINE = 64;
+
+			// Variables:
+				Data_t buf_[capasity_];
+
+				alignas(CACHE_LINE) std::atomic<size_t> beg_; // Written by consumer only
+				alignas(CACHE_LINE) std::atomic<size_t> end_; // Written by producer only
+
+				std::atomic<bool> closed_;
+
+				Metrics_t metrics_;
+
+		public:
+			// Dtor:
+				~SpscQueue() = default;
+
+			// Ctor:
+				SpscQueue();
+
+			// Copy and move are meaningless for a queue shared by two threads:
+				SpscQueue           (const SpscQueue&) = delete;
+				SpscQueue& operator=(const SpscQueue&) = delete;
+
+			// Producer side:
+				bool try_push_back(const Data_t& data);
+
+				// Pushes as many elements as fit, returns the number pushed
+				size_t try_push_back(const Data_t* data, size_t count);
+
+				// No more elements will be pushed
+				void close();
+
+			// Consumer side:
+				bool try_pop_front(Data_t& data);
+
+				// Pops up to maxCount elements, returns the number popped
+				size_t try_pop_front(Data_t* data, size_t maxCount);
+
+				// True if the producer closed the queue and everything is popped
+				bool finished() const;
+
+			// Any side:
+				inline size_t capasity() const { return capasity_; }
+
+				inline size_t size() const
+				{
+					return end_.load(std::memory_order_acquire) - beg_.load(std::memory_order_acquire);
+				}
+
+				inline const Metrics_t& metrics() const { return metrics_; }
+		};
+
+		//-----------------------------------------------------------
+		// Implementation:
+		//-----------------------------------------------------------
+
+			// Ctor:
+				template <typename Data_t, size_t capasity_, typename Metrics_t>
+				SpscQueue<Data_t, capasity_, Metrics_t>::SpscQueue() :
+					buf_     (),
+					beg_     (0),
+					end_     (0),
+					closed_  (false),
+					metrics_ ()
+				{}
+
+			// Producer side:
+				template <typename Data_t, size_t capasity_, typename Metrics_t>
+				bool SpscQueue<Data_t, capasity_, Metrics_t>::try_push_back(const Data_t& data)
+				{
+					return try_push_back(&data, 1) == 1;
+				}
+
+				template <typename Data_t, size_t capasity_, typename Metrics_t>
+				size_t SpscQueue<Data_t, capasity_, Metrics_t>::try_push_back(const Data_t* data, size_t count)
+				{
+					size_t end = end_.load(std::memory_order_relaxed);
+					size_t beg = beg_.load(std::memory_order_acquire);
+
+					size_t toPush = capasity_ - (end - beg);
+					if (count < toPush) toPush = count;
+
+					for (size_t i = 0; i < toPush; ++i)
+					{
+						buf_[(end + i) % capasity_] = data[i];
+					}
+
+					end_.store(end + toPush, std::memory_order_release);
+
+					metrics_.onPush(toPush, count, end + toPush - beg);
+
+					return toPush;
+				}
+
+				template <typename Data_t, size_t capasity_, typename Metrics_t>
+				void SpscQueue<Data_t, capasity_, Metrics_t>::close()
+				{
+					closed_.store(true, std::memory_order_release);
+				}
+
+			// Consumer side:
+				template <typename Data_t, size_t capasity_, typename Metrics_t>
+				bool SpscQueue<Data_t, capasity_, Metrics_t>::try_pop_front(Data_t& data)
+				{
+					return try_pop_front(&data, 1) == 1;
+				}
+
+				template <typename Data_t, size_t capasity_, typename Metrics_t>
+				size_t SpscQueue<Data_t, capasity_, Metrics_t>::try_pop_front(Data_t* data, size_t maxCount)
+				{
+					size_t beg = beg_.load(std::memory_order_relaxed);
+					size_t end = end_.load(std::memory_order_acquire);
+
+					size_t toPop = end - beg;
+					if (maxCount < toPop) toPop = maxCount;
+
+					for (size_t i = 0; i < toPop; ++i)
+					{
+						data[i] = std::move(buf_[(beg + i) % capasity_]);
+					}
+
+					beg_.store(beg + toPop, std::memory_order_release);
+
+					metrics_.onPop(toPop, maxCount);
+
+					return toPop;
+				}
+
+				template <typename Data_t, size_t capasity_, typename Metrics_t>
+				bool SpscQueue<Data_t, capasity_, Metrics_t>::finished() const
+				{
+					// closed_ has to be read first: everything pushed before close() is visible after it
+					return closed_.load(std::memory_order_acquire) &&
+					       end_.load(std::memory_order_acquire) == beg_.load(std::memory_order_relaxed);
+				}
+
+	} // namespace _spsc_queue
+
+	template <typename Data_t, size_t capasity_, typename Metrics_t = NoQueueMetrics>
+	using SpscQueue = _spsc_queue::SpscQueue<Data_t, capasity_, Metrics_t>;
+
+}
+
+#endif /* HEADER_GUARD_VA_SPSC_QUEUE_INCLUDED */
\ No newline at end of file
@@ -18,8 +18,13 @@
 
 // Includes:
 #include <exception>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <cstdlib>
 
@@ -40,48 +45,395 @@ namespace VaExc
 	namespace _control
 	{
 		// Some bounds:
-		const size_t MAX_INFO_SIZE = 400; ///< The maximumum amount of bytes an Exception can store.
-		const size_t MAX_MSG_SIZE  = 200; ///< The maximumum amount of bytes an explanation message in Exception can store.
-		const size_t MAX_EXC_COUNT = 4;   ///< The maximumum amount of Exception instances in "caused-by" chains.
+		const size_t MAX_INFO_SIZE  = 400; ///< The maximumum amount of bytes an Exception can store.
+		const size_t MAX_MSG_SIZE   = 200; ///< The maximumum amount of bytes an explanation message in Exception can store.
+		const size_t MAX_MSG_ARGS   = 4;   ///< The maximumum amount of arguments of an explanation message.
+		const size_t MAX_INFO_PARTS = 8;   ///< The maximumum amount of pieces (message, file, function, line) of one Exception.
+		const size_t MAX_EXC_COUNT  = 4;   ///< The maximumum amount of Exception instances in "caused-by" chains.
 
 		const size_t NOT_ENOUGH_SPACE_SIZE = 4; ///< The size of NOT_ENOUGH_SPACE array.
 		const char   NOT_ENOUGH_SPACE[NOT_ENOUGH_SPACE_SIZE + 1] = "\n..."; ///< The string, which is printed out in case there's not enough space to print something.
 
 	} // namespace _control
 
+	/** @brief  Printf-style formatting, checked at compile time and done only when the text is needed (not for user).
+
+	            Messages keep their arguments (numbers and pointers, strings are copied by the Exception) and are
+	            formatted by Exception::what(), so an Exception that is caught and handled never formats anything.
+	*/
+	namespace _format
+	{
+		/// What printf can take for an argument.
+		enum class Category : unsigned char
+		{
+			Integral,
+			Floating,
+			String,
+			Pointer,
+			Unsupported
+		};
+
+		template <typename T>
+		constexpr Category categoryOf() noexcept
+		{
+			using U = std::decay_t<T>;
+
+			return std::is_integral<U>::value || std::is_enum<U>::value                              ? Category::Integral :
+			       std::is_floating_point<U>::value && !std::is_same<U, long double>::value          ? Category::Floating :
+			       std::is_same<U, const char*>::value || std::is_same<U, char*>::value              ? Category::String   :
+			       std::is_null_pointer<U>::value ||
+			       (std::is_pointer<U>::value && !std::is_function<std::remove_pointer_t<U>>::value) ? Category::Pointer  :
+			                                                                                           Category::Unsupported;
+		}
+
+		/// An argument type after the default promotions of a variadic call.
+		struct ArgType
+		{
+			Category category;
+			size_t   size;
+		};
+
+		template <typename T>
+		constexpr ArgType argTypeOf() noexcept
+		{
+			using U = std::decay_t<T>;
+
+			return {categoryOf<T>(), categoryOf<T>() == Category::Integral && sizeof(U) < sizeof(int) ? sizeof(int) : sizeof(U)};
+		}
+
+		/// One conversion specification: %[flags][width][.precision][length]conversion.
+		struct Spec
+		{
+			size_t length;     ///< Of the whole specification, '%' included.
+			size_t stars;      ///< Width and precision given as int arguments.
+			char   modifier;   ///< 0, 'H' (hh), 'h', 'l', 'q' (ll), 'j', 'z', 't' or 'L'.
+			char   conversion; ///< 0 if the specification is broken or not supported (%n).
+		};
+
+		constexpr bool isOneOf(char c, const char* set) noexcept
+		{
+			for (; *set != '\0'; ++set)
+			{
+				if (*set == c) return true;
+			}
+
+			return false;
+		}
+
+		constexpr bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+		/// spec points to the '%'.
+		constexpr Spec parseSpec(const char* spec) noexcept
+		{
+			size_t i     = 1;
+			size_t stars = 0;
+
+			while (isOneOf(spec[i], "-+ #0")) ++i;
+
+			if (spec[i] == '*') { ++stars; ++i; }
+			else while (isDigit(spec[i])) ++i;
+
+			if (spec[i] == '.')
+			{
+				++i;
+
+				if (spec[i] == '*') { ++stars; ++i; }
+				else while (isDigit(spec[i])) ++i;
+			}
+
+			char modifier = 0;
+
+			if      (spec[i] == 'h' && spec[i + 1] == 'h') { modifier = 'H';     i += 2; }
+			else if (spec[i] == 'l' && spec[i + 1] == 'l') { modifier = 'q';     i += 2; }
+			else if (isOneOf(spec[i], "hljztL"))           { modifier = spec[i]; i += 1; }
+
+			char conversion = isOneOf(spec[i], "diouxXcsfFeEgGaAp") ? spec[i] : 0;
+
+			return {i + 1, stars, modifier, conversion};
+		}
+
+		/// The size of the integer the length modifier wants, hh and h take a promoted int.
+		constexpr size_t integralSize(char modifier) noexcept
+		{
+			return modifier == 'l' ? sizeof(long)      :
+			       modifier == 'q' ? sizeof(long long) :
+			       modifier == 'j' ? sizeof(intmax_t)  :
+			       modifier == 'z' ? sizeof(size_t)    :
+			       modifier == 't' ? sizeof(ptrdiff_t) : sizeof(int);
+		}
+
+		/// Whether an argument of the type is what the specification wants.
+		constexpr bool fits(const Spec& spec, const ArgType& type) noexcept
+		{
+			switch (spec.conversion)
+			{
+				case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+					return type.category == Category::Integral && type.size == integralSize(spec.modifier);
+
+				case 'c':
+					return type.category == Category::Integral && type.size == sizeof(int) && spec.modifier == 0;
+
+				case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+					return type.category == Category::Floating && (spec.modifier == 0 || spec.modifier == 'l');
+
+				case 's':
+					return type.category == Category::String && spec.modifier == 0;
+
+				case 'p':
+					return (type.category == Category::Pointer || type.category == Category::String) && spec.modifier == 0;
+
+				default:
+					return false;
+			}
+		}
+
+		/// True if the arguments match the format: their count, kinds and integer sizes.
+		template <typename... Args>
+		constexpr bool check(const char* format) noexcept
+		{
+			const ArgType types[] = {argTypeOf<Args>()..., ArgType{Category::Unsupported, 0}};
+			const size_t  count   = sizeof...(Args);
+
+			size_t next = 0;
+
+			for (size_t i = 0; format[i] != '\0';)
+			{
+				if (format[i] != '%')      { i += 1; continue; }
+				if (format[i + 1] == '%')  { i += 2; continue; }
+
+				Spec spec = parseSpec(format + i);
+				if (spec.conversion == 0) return false;
+
+				for (size_t star = 0; star < spec.stars; ++star, ++next)
+				{
+					if (next >= count || types[next].category != Category::Integral || types[next].size != sizeof(int)) return false;
+				}
+
+				if (next >= count || !fits(spec, types[next])) return false;
+
+				++next;
+				i += spec.length;
+			}
+
+			return next == count;
+		}
+
+		/// check() for the types of a std::tuple but the first one, the format itself (used by VAEXC_MSG).
+		template <typename Tuple>
+		struct CheckTuple;
+
+		template <typename Format, typename... Args>
+		struct CheckTuple<std::tuple<Format, Args...>>
+		{
+			static constexpr bool check(const char* format) noexcept { return _format::check<Args...>(format); }
+		};
+
+		/// Compile errors of VAEXC_STATUS, it can't use a lambda like VAEXC_MSG: __FUNCTION__ has to stay the caller's.
+		template <bool formatMatches, bool oneArgument>
+		struct StatusCheck
+		{
+			static_assert(oneArgument,   "VAEXC_STATUS: a Status keeps at most one argument");
+			static_assert(formatMatches, "VAEXC_STATUS: the format doesn't match the argument");
+		};
+
+		/// An argument kept for formatting; a string is an offset into the strings of its Exception.
+		struct Arg
+		{
+			Category category;
+
+			union
+			{
+				long long   integral; // Unsigned values are kept bit for bit
+				double      floating;
+				const char* string;
+				const void* pointer;
+				size_t      offset;
+			};
+		};
+
+		template <typename T>
+		struct AlwaysFalse : std::false_type {};
+
+		template <typename T>
+		Arg makeArg(T&& value) noexcept
+		{
+			constexpr Category category = categoryOf<T>();
+
+			Arg arg;
+			arg.category = category;
+
+			if      constexpr (category == Category::Integral) arg.integral = static_cast<long long>(value);
+			else if constexpr (category == Category::Floating) arg.floating = static_cast<double>(value);
+			else if constexpr (category == Category::String  ) arg.string   = value;
+			else if constexpr (category == Category::Pointer ) arg.pointer  = static_cast<const void*>(value);
+			else static_assert(AlwaysFalse<T>::value, "VaExc: printf can't take an argument of this type (std::string? pass c_str())");
+
+			return arg;
+		}
+
+		/** @brief  std::snprintf() with the kept arguments, casting them to exactly the types the format asks for.
+
+		            Output is truncated (and always terminated) just like snprintf() does. Missing or mismatching
+		            arguments print as '?' instead of being undefined behavior.
+
+		    @return The length of the output, -1 on an output error.
+		*/
+		inline int format(char* out, size_t size, const char* format, const Arg* args, size_t argCount, const char* strings) noexcept
+		{
+			if (size == 0) return 0;
+
+			size_t pos  = 0;
+			size_t next = 0;
+
+			// Everything is written through this, so the output can't overflow
+			auto append = [size, &pos] (int written) -> bool
+			{
+				if (written < 0) return false;
+
+				pos = std::min(pos + static_cast<size_t>(written), size - 1);
+				return true;
+			};
+
+			auto putChar = [out, size, &pos] (char c)
+			{
+				if (pos + 1 < size) out[pos++] = c;
+			};
+
+			for (size_t i = 0; format[i] != '\0';)
+			{
+				if (format[i] != '%')     { putChar(format[i]); i += 1; continue; }
+				if (format[i + 1] == '%') { putChar('%');       i += 2; continue; }
+
+				Spec spec = parseSpec(format + i);
+
+				char specText[32] = {};
+				bool broken       = spec.conversion == 0 || spec.length >= sizeof(specText);
+
+				if (!broken) std::memcpy(specText, format + i, spec.length);
+
+				int stars[2] = {0, 0};
+
+				for (size_t star = 0; star < spec.stars; ++star, ++next)
+				{
+					if (next >= argCount || args[next].category != Category::Integral) broken = true;
+					else stars[star] = static_cast<int>(args[next].integral);
+				}
+
+				const Arg* arg = next < argCount ? &args[next] : nullptr;
+				++next;
+
+				i += spec.length;
+
+				// The wanted category, the same as the compile time check uses
+				Category wanted = isOneOf(spec.conversion, "diouxXc")  ? Category::Integral :
+				                  isOneOf(spec.conversion, "fFeEgGaA") ? Category::Floating :
+				                  spec.conversion == 's'               ? Category::String   : Category::Pointer;
+
+				if (broken || arg == nullptr || (arg->category != wanted && !(wanted == Category::Pointer && arg->category == Category::String)))
+				{
+					putChar('?');
+					continue;
+				}
+
+				auto print = [&] (auto value) -> int
+				{
+					char* at   = out + pos;
+					size_t left = size - pos;
+
+					switch (spec.stars)
+					{
+						case 0:  return std::snprintf(at, left, specText, value);
+						case 1:  return std::snprintf(at, left, specText, stars[0], value);
+						default: return std::snprintf(at, left, specText, stars[0], stars[1], value);
+					}
+				};
+
+				long long value   = arg->integral;
+				int       written = 0;
+
+				switch (spec.conversion)
+				{
+					case 'd': case 'i':
+						switch (spec.modifier)
+						{
+							case 'l': written = print(static_cast<long>(value));                     break;
+							case 'q': written = print(static_cast<long long>(value));                break;
+							case 'j': written = print(static_cast<intmax_t>(value));                 break;
+							case 'z': written = print(static_cast<std::make_signed_t<size_t>>(value)); break;
+							case 't': written = print(static_cast<ptrdiff_t>(value));                break;
+							default:  written = print(static_cast<int>(value));                      break;
+						}
+						break;
+
+					case 'o': case 'u': case 'x': case 'X':
+						switch (spec.modifier)
+						{
+							case 'l': written = print(static_cast<unsigned long>(value));               break;
+							case 'q': written = print(static_cast<unsigned long long>(value));          break;
+							case 'j': written = print(static_cast<uintmax_t>(value));                   break;
+							case 'z': written = print(static_cast<size_t>(value));                      break;
+							case 't': written = print(static_cast<std::make_unsigned_t<ptrdiff_t>>(value)); break;
+							default:  written = print(static_cast<unsigned>(value));                    break;
+						}
+						break;
+
+					case 'c':
+						written = print(static_cast<int>(value));
+						break;
+
+					case 's':
+						written = print(strings + arg->offset);
+						break;
+
+					case 'p':
+						written = print(arg->category == Category::String ? static_cast<const void*>(strings + arg->offset) : arg->pointer);
+						break;
+
+					default:
+						written = print(arg->floating);
+						break;
+				}
+
+				if (!append(written)) return -1;
+			}
+
+			out[pos] = '\0';
+
+			return static_cast<int>(pos);
+		}
+
+	} // namespace _format
+
 	/// Wrappers to be used in Exception constructor (Exception()), mostly not for user use.
 	namespace _wrappers
 	{
-		/** @brief  Wrapper that stores exception message.
+		/** @brief  Wrapper that stores exception message, formatted only if Exception::what() is called.
 
-		    @see    Exception
+		            Strings are copied into the Exception when it is constructed, everything else is kept as it is.
+		            Formats are checked at compile time, if the message is made with VAEXC_MSG().
+
+		    @see    Exception, VAEXC_MSG
 		    @code
-		            throw Exception(..., ArgMsg("Too many kitten explosions per second. %ull total", kitExpPerSec), ...);
+		            throw Exception(..., VAEXC_MSG("Too many kitten explosions per second. %llu total", kitExpPerSec), ...);
 		    @endcode
 		*/
 		struct ArgMsg
 		{
-			char msg[_control::MAX_MSG_SIZE + 1];
+			const char*  format;
+			_format::Arg args[_control::MAX_MSG_ARGS];
+			size_t       argCount;
 
 			/** @brief   ArgMsg Constructor
 
 				@see     ArgMsg
 			*/
 			template <typename... Args>
-			explicit ArgMsg(const char* format, Args&&... args) noexcept :
-				msg ()
+			explicit ArgMsg(const char* fmt, Args&&... arguments) noexcept :
+				format   (fmt),
+				args     {_format::makeArg(std::forward<Args>(arguments))...},
+				argCount (sizeof...(Args))
 			{
-				int written = std::snprintf(msg, sizeof(msg), format, std::forward<Args>(args)...);
-
-				if (written < 0)
-				{
-					written = std::sprintf(msg, "%s", _control::NOT_ENOUGH_SPACE);
-
-					if (written < 0)
-					{
-						msg[0] = '\0';
-					}
-				}
+				static_assert(sizeof...(Args) <= _control::MAX_MSG_ARGS, "ArgMsg: too many arguments (see _control::MAX_MSG_ARGS)");
 			}
 		};
 
@@ -198,59 +550,240 @@ namespace VaExc
 	/// Namespace for ErrorInfo struct to store information conviniently (not for user).
 	namespace _errorInfo
 	{
-		/// Class, which is only useful in Exception implementation (not for user).
+		/** @brief  Class, which is only useful in Exception implementation (not for user).
+
+		            Keeps the pieces of one Exception in the order they were given and turns them into text only in
+		            render(). Arrays are used (and copied) only up to their counters, so constructing and copying
+		            an ErrorInfo doesn't touch the whole object.
+		*/
 		class ErrorInfo
 		{
 		public:
 				ErrorInfo() noexcept :
-					info_   (),
-					filled_ (0)
+					partCount_   (0),
+					plain_       (false),
+					msgOffset_   (0),
+					argCount_    (0),
+					fileOffset_  (0),
+					funcOffset_  (0),
+					line_        (0),
+					textOffset_  (0),
+					stringsUsed_ (0)
+				{}
+
+				ErrorInfo(const ErrorInfo& that) noexcept :
+					ErrorInfo()
 				{
-					std::memset(info_, 0, sizeof(info_));
+					*this = that;
 				}
 
-				ErrorInfo(const ErrorInfo& that) = default;
-
-				ErrorInfo& operator=(const ErrorInfo& that) = default;
+				ErrorInfo& operator=(const ErrorInfo& that) noexcept
+				{
+					if (this == &that) return *this;
+
+					partCount_   = that.partCount_;
+					plain_       = that.plain_;
+					msgOffset_   = that.msgOffset_;
+					argCount_    = that.argCount_;
+					fileOffset_  = that.fileOffset_;
+					funcOffset_  = that.funcOffset_;
+					line_        = that.line_;
+					textOffset_  = that.textOffset_;
+					stringsUsed_ = that.stringsUsed_;
+
+					std::memcpy(parts_,   that.parts_,   partCount_   * sizeof(parts_[0]));
+					std::memcpy(args_,    that.args_,    argCount_    * sizeof(args_[0]));
+					std::memcpy(strings_, that.strings_, stringsUsed_ * sizeof(strings_[0]));
+
+					return *this;
+				}
 
 				~ErrorInfo() = default;
 
-			// Interface:
-				bool writeInfoWithCaption(const char* caption, const char* text) noexcept
+			// Interface, strings are copied: the caller's ones may be gone by the time what() is called
+				void explain(const _wrappers::ArgMsg& msg) noexcept
+				{
+					plain_     = false;
+					msgOffset_ = keepPiece(msg.format);
+					argCount_  = msg.argCount;
+
+					for (size_t i = 0; i < argCount_; ++i)
+					{
+						args_[i] = msg.args[i];
+
+						if (args_[i].category == _format::Category::String)
+						{
+							args_[i].offset = keepString(msg.args[i].string != nullptr ? msg.args[i].string : "(null)", _control::MAX_MSG_SIZE);
+						}
+					}
+
+					addPart(Part::Explanation);
+				}
+
+				void explain(const char* msg) noexcept
+				{
+					plain_     = true;
+					msgOffset_ = keepPiece(msg);
+
+					addPart(Part::Explanation);
+				}
+
+				void setFile    (const char* file) noexcept { fileOffset_ = keepPiece(file); addPart(Part::File);     }
+				void setFunction(const char* func) noexcept { funcOffset_ = keepPiece(func); addPart(Part::Function); }
+				void setLine    (size_t      line) noexcept { line_       = line;            addPart(Part::Line);     }
+
+				/// Text of a foreign exception, copied as it is.
+				void setText(const char* text) noexcept
+				{
+					textOffset_ = keepPiece(text);
+
+					addPart(Part::Text);
+				}
+
+				/// The text of the pieces with their captions, info has to hold MAX_INFO_SIZE + 1 bytes.
+				void render(char* info) const noexcept
+				{
+					size_t filled = 0;
+					info[0] = '\0';
+
+					for (size_t i = 0; i < partCount_; ++i)
+					{
+						switch (parts_[i])
+						{
+							case Part::Explanation:
+							{
+								char msg[_control::MAX_MSG_SIZE + 1];
+
+								if (plain_ || msgOffset_ == TOO_LONG) writeInfoWithCaption(info, filled, "\nExplanation: ", kept(msgOffset_));
+								else
+								{
+									if (_format::format(msg, sizeof(msg), kept(msgOffset_), args_, argCount_, strings_) < 0)
+									{
+										std::strcpy(msg, _control::NOT_ENOUGH_SPACE);
+									}
+
+									writeInfoWithCaption(info, filled, "\nExplanation: ", msg);
+								}
+								break;
+							}
+
+							case Part::File:     writeInfoWithCaption(info, filled, "\nIn file: ",     kept(fileOffset_)); break;
+							case Part::Function: writeInfoWithCaption(info, filled, "\nIn function: ", kept(funcOffset_)); break;
+
+							case Part::Line:
+							{
+								char buf[24]; // Thats enough for a number representation
+
+								if (std::snprintf(buf, sizeof(buf), "%zu", line_) >= 0) writeInfoWithCaption(info, filled, "\nIn line: ",            buf);
+								else                                                     writeInfoWithCaption(info, filled, "\nIn line: ", "Unknown line");
+								break;
+							}
+
+							case Part::Text: writeInfoWithCaption(info, filled, "", kept(textOffset_)); break;
+						}
+					}
+				}
+
+		private:
+			enum class Part : unsigned char
+			{
+				Explanation,
+				File,
+				Function,
+				Line,
+				Text
+			};
+
+			// Variables:
+				Part   parts_[_control::MAX_INFO_PARTS];
+				size_t partCount_;
+
+				bool         plain_;     // The explanation at msgOffset_ is plain text, not a format
+				size_t       msgOffset_;
+				_format::Arg args_[_control::MAX_MSG_ARGS];
+				size_t       argCount_;
+
+				size_t fileOffset_;
+				size_t funcOffset_;
+				size_t line_;
+
+				size_t textOffset_;
+
+				// Copies of the strings the pieces refer to
+				char   strings_[_control::MAX_INFO_SIZE + 1];
+				size_t stringsUsed_;
+
+			// Helper functions:
+				void addPart(Part part) noexcept
+				{
+					if (partCount_ < _control::MAX_INFO_PARTS) parts_[partCount_++] = part;
+				}
+
+				/// Copies up to maxLength bytes of the string, as much as there is space for; returns its offset.
+				size_t keepString(const char* str, size_t maxLength) noexcept
+				{
+					size_t offset = stringsUsed_;
+					size_t length = 0;
+					while (length < maxLength && str[length] != '\0') ++length;
+
+					if (length > _control::MAX_INFO_SIZE - offset) length = _control::MAX_INFO_SIZE - offset;
+
+					std::memcpy(strings_ + offset, str, length);
+					strings_[offset + length] = '\0';
+
+					stringsUsed_ = std::min(offset + length + 1, _control::MAX_INFO_SIZE);
+
+					return offset;
+				}
+
+				static const size_t TOO_LONG = static_cast<size_t>(-1); ///< Offset of a string that had no space.
+
+				/// Copies the whole string, or nothing if there's no space for it (then it's printed as NOT_ENOUGH_SPACE).
+				size_t keepPiece(const char* str) noexcept
+				{
+					size_t length = 0;
+					while (length <= _control::MAX_INFO_SIZE && str[length] != '\0') ++length;
+
+					if (length > _control::MAX_INFO_SIZE - stringsUsed_) return TOO_LONG;
+
+					return keepString(str, length);
+				}
+
+				const char* kept(size_t offset) const noexcept
+				{
+					return offset != TOO_LONG ? strings_ + offset : nullptr;
+				}
+
+				static bool writeInfoWithCaption(char* info, size_t& filled, const char* caption, const char* text) noexcept
 				{
+					// No text is one that didn't fit into the copies
 					size_t captionLen = std::strlen(caption);
-					size_t    textLen = std::strlen(   text);
+					size_t    textLen = text != nullptr ? std::strlen(text) : _control::MAX_INFO_SIZE;
 
-					if (filled_ + captionLen + textLen + _control::NOT_ENOUGH_SPACE_SIZE > _control::MAX_INFO_SIZE)
+					if (filled + captionLen + textLen + _control::NOT_ENOUGH_SPACE_SIZE > _control::MAX_INFO_SIZE)
 					{
-						std::strcpy(info_ + filled_, _control::NOT_ENOUGH_SPACE);
+						// Never past the buffer, even after several pieces didn't fit
+						if (filled + _control::NOT_ENOUGH_SPACE_SIZE <= _control::MAX_INFO_SIZE)
+						{
+							std::strcpy(info + filled, _control::NOT_ENOUGH_SPACE);
 
-						filled_ += _control::NOT_ENOUGH_SPACE_SIZE;
+							filled += _control::NOT_ENOUGH_SPACE_SIZE;
+						}
 
 						return false;
 					}
 					else
 					{
-						std::strcpy(info_ + filled_, caption);
-						filled_ += captionLen;
+						std::strcpy(info + filled, caption);
+						filled += captionLen;
 
-						std::strcpy(info_ + filled_, text);
-						filled_ += textLen;
+						std::strcpy(info + filled, text);
+						filled += textLen;
 
 						return true;
 					}
 				}
 
-				const char* info() const noexcept
-				{
-					return reinterpret_cast<const char*>(info_);
-				}
-
-		private:
-			// Variables:
-				char info_[_control::MAX_INFO_SIZE + 1];
-				size_t filled_;
-
 		};
 
 	} //  namespace _errorInfo
@@ -262,11 +795,15 @@ namespace VaExc
 	            Exception is inherited from std::exception (thus, it is a std::exception),
 	            Exception supports formatted strings, just like std::printf.
 
+	            Nothing is formatted until what() is called: an Exception that is caught and handled costs about
+	            as much as copying its arguments.
+
 	    @see    operator""_msg(),
 	            operator""_file(),
 	            operator""_func(),
 	            operator""_line(),
 	            _wrappers::ArgMsg::ArgMsg(),
+	            VAEXC_MSG,
 	            VAEXC_POS
 
 	    @par    Examples
@@ -275,14 +812,14 @@ namespace VaExc
 	            {
 	            	using namespace VaExc;
 
-                	// ArgMsg is implemented via std::sprintf, so formatting is the same.
-	            	throw Exception(ArgMsg("Error code: %d", error_code), VAEXC_POS);
+                	// Formatting is the same as std::printf, VAEXC_MSG checks the format at compile time.
+	            	throw Exception(VAEXC_MSG("Error code: %d", error_code), VAEXC_POS);
 
 	            	...
                 }
 	            catch (Exception& exc)
 	            {
-	            	throw Exception("Exception occured!!!", exc);
+	            	throw Exception("Exception occured!!!"_msg, std::move(exc));
 	            }
 
                 ...
@@ -297,7 +834,7 @@ namespace VaExc
 	            }
 	            catch (std::exception& exc) // Also catches Exception
 	            {
-	            	throw Exception("Exception occured!!!", VAEXC_POS, exc);
+	            	throw Exception("Exception occured!!!"_msg, VAEXC_POS, std::move(exc));
 	            }
 	    @endcode
 	*/
@@ -352,7 +889,7 @@ namespace VaExc
 		template <class... Args>
 		void Exception::parseArgs(_wrappers::ArgMsg&& msg, Args&&... args) noexcept
 		{
-			excepts_[0].writeInfoWithCaption("\nExplanation: ", msg.msg);
+			excepts_[0].explain(msg);
 
 			parseArgs(std::forward<Args>(args)...);
 		}
@@ -360,7 +897,7 @@ namespace VaExc
 		template <class... Args>
 		void Exception::parseArgs(_wrappers::ArgMsgConstexpr&& msg, Args&&... args) noexcept
 		{
-			excepts_[0].writeInfoWithCaption("\nExplanation: ", msg.msg);
+			excepts_[0].explain(msg.msg);
 
 			parseArgs(std::forward<Args>(args)...);
 		}
@@ -368,7 +905,7 @@ namespace VaExc
 		template <class... Args>
 		void Exception::parseArgs(_wrappers::ArgFilename&& file, Args&&... args) noexcept
 		{
-			excepts_[0].writeInfoWithCaption("\nIn file: ", file.file);
+			excepts_[0].setFile(file.file);
 
 			parseArgs(std::forward<Args>(args)...);
 		}
@@ -376,7 +913,7 @@ namespace VaExc
 		template <class... Args>
 		void Exception::parseArgs(_wrappers::ArgFunction&& func, Args&&... args) noexcept
 		{
-			excepts_[0].writeInfoWithCaption("\nIn function: ", func.func);
+			excepts_[0].setFunction(func.func);
 
 			parseArgs(std::forward<Args>(args)...);
 		}
@@ -384,12 +921,7 @@ namespace VaExc
 		template <class... Args>
 		void Exception::parseArgs(_wrappers::ArgLine&& line, Args&&... args) noexcept
 		{
-			static char buf[20]; // Thats enough for a number representation
-
-			int written = std::sprintf(buf, "%zu", line.line);
-
-			if (written >= 0) excepts_[0].writeInfoWithCaption("\nIn line: ",            buf);
-			else              excepts_[0].writeInfoWithCaption("\nIn line: ", "Unknown line");
+			excepts_[0].setLine(line.line);
 
 			parseArgs(std::forward<Args>(args)...);
 		}
@@ -411,7 +943,7 @@ namespace VaExc
 		{
 			if (excCount_ < _control::MAX_EXC_COUNT)
 			{
-				excepts_[excCount_].writeInfoWithCaption("", exc.what());
+				excepts_[excCount_].setText(exc.what());
 				++excCount_;
 			}
 
@@ -419,9 +951,15 @@ namespace VaExc
 		}
 
 		template <class T, class... Args>
-		void Exception::parseArgs(T&&, Args&&...) noexcept
+		void Exception::parseArgs(T&& exc, Args&&... args) noexcept
 		{
-			static_assert(sizeof(T) == 0, "VaExc ctor: Unknown argument type (Expected: ArgMsg, ArgFilename, ArgFunction, ArgLine, Exception, std::exception)");
+			// Causes caught by reference and std::exception descendants end up here, they are only read
+			using Cause = std::decay_t<T>;
+
+			static_assert(std::is_base_of<std::exception, Cause>::value, "VaExc ctor: Unknown argument type (Expected: ArgMsg, ArgFilename, ArgFunction, ArgLine, Exception, std::exception)");
+
+			if constexpr (std::is_base_of<Exception, Cause>::value) parseArgs(static_cast<Exception&&>     (const_cast<Cause&>(exc)), std::forward<Args>(args)...);
+			else                                                    parseArgs(static_cast<std::exception&&>(const_cast<Cause&>(exc)), std::forward<Args>(args)...);
 		}
 
 		void Exception::parseArgs() noexcept {}
@@ -442,14 +980,23 @@ namespace VaExc
 		{
 			// 15 there (vvvv) is the approximate size of string "\n\nCaused by:\n\n"
 			static constexpr size_t outputSize = (_control::MAX_INFO_SIZE + 15) * _control::MAX_EXC_COUNT;
-			static char output[outputSize + 1];
+
+			// Per thread: stages on different threads report their exceptions at the same time
+			static thread_local char output[outputSize + 1];
+
+			char info[_control::MAX_INFO_SIZE + 1];
 
 			// That is the initialisation for output
 			output[0] = '\0';
 
-			for (size_t excI = 0, strI = 0; excI < excCount_ && strI < outputSize - _control::NOT_ENOUGH_SPACE_SIZE; ++excI)
+			// Causes past MAX_EXC_COUNT are counted, but not kept
+			size_t excCount = std::min(excCount_, _control::MAX_EXC_COUNT);
+
+			for (size_t excI = 0, strI = 0; excI < excCount && strI < outputSize - _control::NOT_ENOUGH_SPACE_SIZE; ++excI)
 			{
-				int written = std::sprintf(output + strI, "%s", excepts_[excI].info());
+				excepts_[excI].render(info);
+
+				int written = std::sprintf(output + strI, "%s", info);
 
 				if (written < 0)
 				{
@@ -459,7 +1006,7 @@ namespace VaExc
 
 				strI += written;
 
-				if (excI + 1 < excCount_)
+				if (excI + 1 < excCount)
 				{
 					written = std::sprintf(output + strI, "\n\nCaused by:\n");
 
@@ -476,9 +1023,142 @@ namespace VaExc
 			return output;
 		}
 
+	/// Lightweight error results for hot paths, turned into Exception only where it is needed.
+	namespace _status
+	{
+		/// What went wrong, for callers that handle the error instead of reporting it.
+		enum class Errc : unsigned char
+		{
+			Ok = 0,
+			Overflow,      ///< No space left.
+			Empty,         ///< Nothing to take.
+			OutOfBounds,   ///< Index past the end.
+			BrokenState,   ///< Internal invariants don't hold.
+			InvalidSymbol  ///< Unknown input value.
+		};
+
+		/** @brief  An error code with everything Exception needs, but without formatting and copying kilobytes.
+
+		            Status is a few words, trivially copyable and never allocates: returning it per element costs
+		            as much as returning a pointer. The message is a printf format (a string literal) with at most
+		            one integer argument, kept as a long long and printed by whatever integer conversion the
+		            format has (%c, %d, %zu...); it's formatted only when the Status is turned into an Exception.
+
+		    @see    VAEXC_STATUS, Expected
+		    @par    Examples
+		    @usage @code
+		            Status try_pop(Data_t& data)
+		            {
+		            	if (empty()) return VAEXC_STATUS(Errc::Empty, "Can't pop from empty Queue");
+
+		            	...
+		            	return {};
+		            }
+
+		            try_pop(data).raiseIfFailed(); // Exception with the position of VAEXC_STATUS
+		    @endcode
+		*/
+		class Status
+		{
+		private:
+			// Variables:
+				Errc        code_;
+				const char* format_;
+				long long   arg_;
+				const char* file_;
+				const char* func_;
+				size_t      line_;
+
+		public:
+				/// Success.
+				constexpr Status() noexcept :
+					code_   (Errc::Ok),
+					format_ (""),
+					arg_    (0),
+					file_   (""),
+					func_   (""),
+					line_   (0)
+				{}
+
+				constexpr Status(Errc code, const char* format, long long arg, const char* file, const char* func, size_t line) noexcept :
+					code_   (code),
+					format_ (format),
+					arg_    (arg),
+					file_   (file),
+					func_   (func),
+					line_   (line)
+				{}
+
+			// Getters:
+				constexpr bool ok()   const noexcept { return code_ == Errc::Ok; }
+				constexpr Errc code() const noexcept { return code_; }
+
+			// Lazy Exception:
+				/// The full Exception; formatting happens here, not where the error was found.
+				Exception exception() const noexcept
+				{
+					return Exception(_wrappers::ArgMsg(format_, arg_),
+					                 _wrappers::ArgFilename(file_), _wrappers::ArgFunction(func_), _wrappers::ArgLine(line_));
+				}
+
+				[[noreturn]] void raise() const
+				{
+					throw exception();
+				}
+
+				void raiseIfFailed() const
+				{
+					if (!ok()) raise();
+				}
+		};
+
+		/** @brief  A value or the Status explaining why there is none.
+
+		    @see    Status
+		*/
+		template <typename T>
+		class Expected
+		{
+		private:
+			// Variables:
+				T      value_;
+				Status status_;
+
+		public:
+				constexpr Expected(const T& value) noexcept :
+					value_  (value),
+					status_ ()
+				{}
+
+				constexpr Expected(const Status& status) noexcept :
+					value_  (),
+					status_ (status)
+				{}
+
+			// Getters:
+				constexpr bool          ok()     const noexcept { return status_.ok(); }
+				constexpr const Status& status() const noexcept { return status_; }
+
+				/// The value if there is one, Exception otherwise.
+				const T& value() const
+				{
+					status_.raiseIfFailed();
+
+					return value_;
+				}
+		};
+
+	} // namespace _status
+
 	// Really useful interface stuff:
 	using ArgMsg = _wrappers::ArgMsg;
 	using namespace _literals;
+
+	using Errc   = _status::Errc;
+	using Status = _status::Status;
+
+	template <typename T>
+	using Expected = _status::Expected<T>;
 }
 
 /// The define for convinience in Exception creation.
@@ -486,4 +1166,33 @@ namespace VaExc
                   VaExc::_wrappers::ArgFunction(__FUNCTION__), \
                   VaExc::_wrappers::ArgLine    (__LINE__)
 
+/** @brief  ArgMsg with the format checked against the arguments at compile time.
+
+            The format has to be a string literal; a wrong count, kind or integer size of an argument is a compile error.
+
+    @code
+            throw Exception(VAEXC_MSG("Can't open %s: %d", path, errno), VAEXC_POS);
+    @endcode
+*/
+#define VAEXC_MSG(...)                                                                                               \
+	([&] () noexcept                                                                                                 \
+	{                                                                                                                \
+		static_assert(VaExc::_format::CheckTuple<decltype(std::make_tuple(__VA_ARGS__))>::check(VAEXC_MSG_FORMAT_(__VA_ARGS__, 0)), \
+		              "VAEXC_MSG: the format doesn't match the arguments");                                         \
+		return VaExc::_wrappers::ArgMsg(__VA_ARGS__);                                                                \
+	}())
+#define VAEXC_MSG_FORMAT_(format, ...) format
+
+/** @brief  Failed Status with the position it is created at, the message is formatted only if it becomes an Exception.
+
+            The format is checked at compile time against the argument, as in VAEXC_MSG (before it's kept as a long long).
+*/
+#define VAEXC_STATUS(code, ...)                                                                                      \
+	(static_cast<void>(VaExc::_format::StatusCheck<                                                                  \
+	     VaExc::_format::CheckTuple<decltype(std::make_tuple(__VA_ARGS__))>::check(VAEXC_MSG_FORMAT_(__VA_ARGS__, 0)), \
+	     std::tuple_size<decltype(std::make_tuple(__VA_ARGS__))>::value <= 2>{}),                                   \
+	 VAEXC_STATUS_ARG_(code, __VA_ARGS__, 0LL, 0))
+#define VAEXC_STATUS_ARG_(code, format, arg, ...) \
+                  VaExc::Status(code, format, static_cast<long long>(arg), __FILE__, __FUNCTION__, __LINE__)
+
 #endif /*HEADER_GUARD_VA_EXCEPTION_HPP_INCLUDED*/
\ No newline at end of file
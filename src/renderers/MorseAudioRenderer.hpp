@@ -0,0 +1,136 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_RENDERER_AUDIO_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_RENDERER_AUDIO_HPP_INCLUDED
+
+#include <atomic>
+#include <cmath>
+
+#include <SDL2/SDL.h>
+
+#include "../queue/VaException.hpp"
+
+#include "MorseRendererInterface.hpp"
+
+namespace morse_audio_renderer
+{
+	using namespace VaExc;
+
+	// Audio constants:
+	const int    AUDIO_FREQUENCY = 44100; // samples per second
+	const Uint16 AUDIO_SAMPLES   = 512;   // device buffer, about 12 ms of latency
+	const double TONE_FREQUENCY  = 600;   // Hz
+	const float  TONE_VOLUME     = 0.25f;
+
+	// SDL subsystems aren't thread-safe to init and quit: main() does it around the pipeline
+	void MorseAudioInit()
+	{
+		if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0)
+		{
+			throw Exception(VAEXC_MSG("Can't initialize SDL audio: %s", SDL_GetError()), VAEXC_POS);
+		}
+	}
+
+	// Quitting audio that isn't initialized does nothing, so error paths can call it too
+	void MorseAudioQuit()
+	{
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+	}
+
+	// Beeps dots and dashes; the sound itself is timed by the audio device
+	class MorseAudioRenderer : public MorseRendererInterface
+	{
+	private:
+		SDL_AudioDeviceID device_;
+
+		std::atomic<long> toneLeft_; // Samples of the tone still to be played
+
+		double phase_; // Audio thread only
+
+		static void fill(void* userdata, Uint8* stream, int length)
+		{
+			MorseAudioRenderer& renderer = *static_cast<MorseAudioRenderer*>(userdata);
+
+			float* samples = reinterpret_cast<float*>(stream);
+			long   count   = length / static_cast<long>(sizeof(float));
+
+			long toneLeft = renderer.toneLeft_.load(std::memory_order_relaxed);
+
+			long tone = toneLeft < count ? toneLeft : count;
+
+			const double phaseStep = 2 * M_PI * TONE_FREQUENCY / AUDIO_FREQUENCY;
+
+			for (long i = 0; i < tone; ++i)
+			{
+				samples[i] = TONE_VOLUME * static_cast<float>(std::sin(renderer.phase_));
+
+				renderer.phase_ += phaseStep;
+			}
+
+			for (long i = tone; i < count; ++i) samples[i] = 0;
+
+			renderer.phase_ = std::fmod(renderer.phase_, 2 * M_PI);
+
+			// Fails if render() has started a new tone meanwhile, which is not ours to shorten
+			renderer.toneLeft_.compare_exchange_strong(toneLeft, toneLeft - tone);
+		}
+
+	public:
+		MorseAudioRenderer() :
+			device_   (0),
+			toneLeft_ (0),
+			phase_    (0)
+		{}
+
+		// An open device would go on calling fill() with this renderer
+		~MorseAudioRenderer() override
+		{
+			if (device_ != 0) SDL_CloseAudioDevice(device_);
+		}
+
+		MorseAudioRenderer           (const MorseAudioRenderer&) = delete;
+		MorseAudioRenderer& operator=(const MorseAudioRenderer&) = delete;
+
+		// Needs MorseAudioInit()
+		void init() override
+		{
+			SDL_AudioSpec wanted{};
+			wanted.freq     = AUDIO_FREQUENCY;
+			wanted.format   = AUDIO_F32SYS;
+			wanted.channels = 1;
+			wanted.samples  = AUDIO_SAMPLES;
+			wanted.callback = fill;
+			wanted.userdata = this;
+
+			// No allowed changes: SDL converts to whatever the device wants
+			device_ = SDL_OpenAudioDevice(nullptr, 0, &wanted, nullptr, 0);
+			if (device_ == 0)
+			{
+				throw Exception(VAEXC_MSG("Can't open audio device: %s", SDL_GetError()), VAEXC_POS);
+			}
+
+			SDL_PauseAudioDevice(device_, 0);
+		}
+
+		void render(const MorseElement& element) override
+		{
+			if (element.symbol != '.' && element.symbol != '-') return;
+
+			toneLeft_.store(static_cast<long>(element.units) * MORSE_TIME_UNIT * AUDIO_FREQUENCY / 1000);
+		}
+
+		void quit() override
+		{
+			if (device_ != 0)
+			{
+				SDL_CloseAudioDevice(device_);
+				device_ = 0;
+			}
+		}
+	};
+
+}  // namespace morse_audio_renderer
+
+using morse_audio_renderer::MorseAudioRenderer;
+using morse_audio_renderer::MorseAudioInit    ;
+using morse_audio_renderer::MorseAudioQuit    ;
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_RENDERER_AUDIO_HPP_INCLUDED
\ No newline at end of file
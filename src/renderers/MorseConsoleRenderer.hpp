@@ -2,66 +2,164 @@
 #define HEADER_GUARD_BOOP_BEEPER_RENDERER_CONSOLE_HPP_INCLUDED
 
 #include <cstdio>
-#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
 
-void MorseConsoleInit()
-{
-	std::system("stty raw -echo");
-}
+#include <termios.h>
+#include <unistd.h>
 
-void MorseConsoleQuit()
-{
-	std::system("stty cooked");
-}
+#include "../trace/Trace.hpp"
+
+#include "../queue/VaException.hpp"
+
+#include "MorseRendererInterface.hpp"
 
-void MorseConsoleRender(MorseSymbol morseSymbol)
+namespace morse_console_renderer
 {
-	switch (morseSymbol)
+	using namespace VaExc;
+
+	// Terminal state to restore on exit:
+	termios savedTermios{};
+	volatile std::sig_atomic_t termiosSaved = 0;
+
+	// Output buffer, written out once per time slot:
+	const size_t OUTPUT_BUFFER_SIZE = 256;
+
+	char   outputBuffer[OUTPUT_BUFFER_SIZE];
+	size_t outputFilled = 0;
+
+	void MorseConsoleFlush()
 	{
-		case '.':
-		{
-			std::printf(".");
-			std::fflush(stdout);
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
-			break;
-		}
-		case '-':
+		size_t written = 0;
+
+		while (written < outputFilled)
 		{
-			std::printf("-");
-			std::fflush(stdout);
-			std::this_thread::sleep_for(std::chrono::milliseconds(300));
-			break;
+			ssize_t result = write(STDOUT_FILENO, outputBuffer + written, outputFilled - written);
+
+			if (result < 0)
+			{
+				if (errno == EINTR) continue;
+
+				break;
+			}
+
+			written += static_cast<size_t>(result);
 		}
-		case ' ':
+
+		outputFilled = 0;
+	}
+
+	void MorseConsoleWrite(const char* text)
+	{
+		for (size_t i = 0; text[i] != '\0'; ++i)
 		{
-			std::printf(" ");
-			std::fflush(stdout);
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
-			break;
+			if (outputFilled == OUTPUT_BUFFER_SIZE) MorseConsoleFlush();
+
+			outputBuffer[outputFilled++] = text[i];
 		}
-		case '_':
+	}
+
+	// Restores the terminal, safe to call from signal handlers and more than once
+	void restoreTerminal()
+	{
+		if (termiosSaved)
 		{
-			break;
+			tcsetattr(STDIN_FILENO, TCSADRAIN, &savedTermios);
+			termiosSaved = 0;
 		}
-		case '<':
+	}
+
+	void restoreTerminalOnSignal(int signal)
+	{
+		restoreTerminal();
+
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+
+	void MorseConsoleQuit()
+	{
+		MorseConsoleFlush();
+
+		restoreTerminal();
+	}
+
+	void MorseConsoleInit()
+	{
+		// Nothing to switch if input is not a terminal (e.g. piped input)
+		if (!isatty(STDIN_FILENO)) return;
+
+		if (tcgetattr(STDIN_FILENO, &savedTermios) != 0)
 		{
-			std::printf("\n\r");
-			std::fflush(stdout);
-			std::this_thread::sleep_for(std::chrono::milliseconds(300));
-			break;
+			throw Exception(VAEXC_MSG("Can't get terminal attributes: %s", std::strerror(errno)), VAEXC_POS);
 		}
-		case '!':
+
+		termios raw = savedTermios;
+		cfmakeraw(&raw);
+
+		if (tcsetattr(STDIN_FILENO, TCSADRAIN, &raw) != 0)
 		{
-			std::printf("!");
-			std::fflush(stdout);
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
-			break;
+			throw Exception(VAEXC_MSG("Can't set terminal to raw mode: %s", std::strerror(errno)), VAEXC_POS);
 		}
-		default:
+
+		termiosSaved = 1;
+
+		// Every exit path has to give the terminal back:
+		std::atexit(MorseConsoleQuit);
+
+		std::signal(SIGTERM, restoreTerminalOnSignal);
+		std::signal(SIGHUP,  restoreTerminalOnSignal);
+		std::signal(SIGABRT, restoreTerminalOnSignal);
+		std::signal(SIGSEGV, restoreTerminalOnSignal);
+	}
+
+	// Prints the symbol, the time slot of the symbol is up to the caller
+	Status MorseConsoleTryRender(MorseSymbol morseSymbol)
+	{
+		MORSE_TRACE_SCOPE("MorseConsoleRender");
+
+		switch (morseSymbol)
 		{
-			throw Exception(ArgMsg("Invalid morse symbol: (%c)", morseSymbol), VAEXC_POS);
+			case '.': MorseConsoleWrite(".");    break;
+			case '-': MorseConsoleWrite("-");    break;
+			case ' ': MorseConsoleWrite(" ");    break;
+			case '_':                            return {};
+			case '<': MorseConsoleWrite("\n\r"); break;
+			case '!': MorseConsoleWrite("!");    break;
+			default:
+			{
+				return VAEXC_STATUS(Errc::InvalidSymbol, "Invalid morse symbol: (%c)", morseSymbol);
+			}
 		}
+
+		// One write per time slot:
+		MorseConsoleFlush();
+
+		return {};
+	}
+
+	void MorseConsoleRender(MorseSymbol morseSymbol)
+	{
+		MorseConsoleTryRender(morseSymbol).raiseIfFailed();
 	}
-}
+
+	class MorseConsoleRenderer : public MorseRendererInterface
+	{
+	public:
+		void render(const MorseElement& element) override { MorseConsoleRender(element.symbol); }
+
+		Status tryRender(const MorseElement& element) override { return MorseConsoleTryRender(element.symbol); }
+
+		void quit() override { MorseConsoleFlush(); }
+	};
+
+}  // namespace morse_console_renderer
+
+using morse_console_renderer::MorseConsoleRenderer;
+using morse_console_renderer::MorseConsoleRender  ;
+using morse_console_renderer::MorseConsoleInit    ;
+using morse_console_renderer::MorseConsoleQuit    ;
 
 #endif  // HEADER_GUARD_BOOP_BEEPER_RENDERER_CONSOLE_HPP_INCLUDED
\ No newline at end of file
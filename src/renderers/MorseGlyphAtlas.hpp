@@ -0,0 +1,154 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_GLYPH_ATLAS_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_GLYPH_ATLAS_HPP_INCLUDED
+
+#include <cstring>
+#include <memory>
+
+#include "../SDL_support/MySDL_Canvas.hpp"
+#include "../queue/VaException.hpp"
+#include "../Morse.hpp"
+
+namespace morse_graphic_renderer
+{
+	using namespace VaExc;
+
+	// Every symbol drawn once into a column of tiles, shown with MySDL::Canvas::blit()
+	class MorseGlyphAtlas
+	{
+	private:
+		static const size_t GLYPH_COUNT = 5;
+
+		// Glyph order in the atlas
+		static const char* glyphSymbols() { return ".- <!"; }
+
+		// Variables:
+			std::unique_ptr<MySDL::Bitmap> atlas_;
+
+			unsigned  tileSide_;
+			SDL_Color lineColor_;
+			SDL_Color backgroundColor_;
+			bool      smooth_;
+
+		// Records the glyph of the symbol for the tile centered at (curX, curY); smooth glyphs have anti-aliased curves and diagonals
+		static void recordGlyph(MySDL::DrawList& list, int curX, int curY, int morseSide, MorseSymbol morseSymbol, const SDL_Color& color, bool smooth)
+		{
+			switch (morseSymbol)
+			{
+				case '.':
+				{
+					if (smooth) list.smoothCircle(curX, curY, morseSide, color);
+					else        list.circle      (curX, curY, morseSide, color);
+					break;
+				}
+				case '-':
+				{
+					// Drawing rectangle
+					list.rect(curX - 3 * morseSide, curY - morseSide, 6 * morseSide + 1, 2 * morseSide + 1, color);
+					break;
+				}
+				case ' ':
+				{
+					// Drawing underscore
+					list.line(curX - 3 * morseSide, curY + 3 * morseSide,
+					          curX + 3 * morseSide, curY + 3 * morseSide, color);
+					break;
+				}
+				case '<':
+				{
+					break;
+				}
+				case '!':
+				{
+					if (smooth)
+					{
+						list.smoothLine(curX - 3 * morseSide, curY - 3 * morseSide,
+						                curX + 3 * morseSide, curY + 3 * morseSide, color);
+						list.smoothLine(curX - 3 * morseSide, curY + 3 * morseSide,
+						                curX + 3 * morseSide, curY - 3 * morseSide, color);
+					}
+					else
+					{
+						list.line(curX - 3 * morseSide, curY - 3 * morseSide,
+						          curX + 3 * morseSide, curY + 3 * morseSide, color);
+						list.line(curX - 3 * morseSide, curY + 3 * morseSide,
+						          curX + 3 * morseSide, curY - 3 * morseSide, color);
+					}
+					break;
+				}
+				default:
+				{
+					throw Exception(VAEXC_MSG("Invalid morse symbol: (%c)", morseSymbol), VAEXC_POS);
+				}
+			}
+		}
+
+		static bool sameColor(const SDL_Color& a, const SDL_Color& b)
+		{
+			return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+		}
+
+	public:
+		MorseGlyphAtlas() :
+			atlas_           (),
+			tileSide_        (0),
+			lineColor_       (),
+			backgroundColor_ (),
+			smooth_          (false)
+		{}
+
+		// Rebuilds the atlas, if the tile size, the colors or the smoothing have changed
+		void prepare(unsigned tileSide, const SDL_Color& lineColor, const SDL_Color& backgroundColor, bool smooth = false)
+		{
+			if (atlas_ && tileSide == tileSide_ && sameColor(lineColor, lineColor_) && sameColor(backgroundColor, backgroundColor_) &&
+			    smooth == smooth_) return;
+
+			atlas_.reset(new MySDL::Bitmap{tileSide, static_cast<unsigned>(tileSide * GLYPH_COUNT)});
+
+			tileSide_        = tileSide;
+			lineColor_       = lineColor;
+			backgroundColor_ = backgroundColor;
+			smooth_          = smooth;
+
+			MySDL::DrawList glyphs{tileSide};
+
+			for (size_t i = 0; i < GLYPH_COUNT; ++i)
+			{
+				recordGlyph(glyphs, tileSide / 2, i * tileSide + tileSide / 2, tileSide / 10, glyphSymbols()[i], lineColor, smooth);
+			}
+
+			atlas_->clear(backgroundColor);
+			atlas_->draw(glyphs);
+		}
+
+		unsigned tileSide() const { return tileSide_; }
+
+		// Top left pixel of the glyph, rows are getPitch() apart
+		Expected<const Uint32*> findGlyph(MorseSymbol morseSymbol) const
+		{
+			const char* found = std::strchr(glyphSymbols(), morseSymbol);
+
+			if (morseSymbol == '\0' || found == nullptr)
+			{
+				return VAEXC_STATUS(Errc::InvalidSymbol, "Invalid morse symbol: (%c)", morseSymbol);
+			}
+
+			return atlas_->getPixels(0, static_cast<int>((found - glyphSymbols()) * tileSide_));
+		}
+
+		const Uint32* glyph(MorseSymbol morseSymbol) const
+		{
+			return findGlyph(morseSymbol).value();
+		}
+
+		size_t getPitch() const { return atlas_->getPitch(); }
+
+		// Copies the glyph of the symbol to the tile at (x, y)
+		void blit(MySDL::Canvas& canvas, MorseSymbol morseSymbol, int x, int y) const
+		{
+			canvas.blit(glyph(morseSymbol), getPitch(), tileSide_, tileSide_, x, y);
+		}
+	};
+
+}  // namespace morse_graphic_renderer
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_GLYPH_ATLAS_HPP_INCLUDED
\ No newline at end of file
@@ -1,19 +1,39 @@
 #ifndef HEADER_GUARD_BOOP_BEEPER_RENDERER_GRAPHIC_HPP_INCLUDED
 #define HEADER_GUARD_BOOP_BEEPER_RENDERER_GRAPHIC_HPP_INCLUDED
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+
 #include "../SDL_support/MySDL_Render.hpp"
+#include "../SDL_support/MySDL_Offscreen.hpp"
+#include "../trace/Trace.hpp"
+
+#include "MorseGlyphAtlas.hpp"
+#include "MorseRendererInterface.hpp"
 
 using namespace VaExc;
 
 namespace morse_graphic_renderer
 {
 	// Rendering constants:
+	// The smallest tile side: a bigger screen gets more tiles, the tiles grow only to fill the leftover
 	const size_t TILE_SIDE = 100;
+	// The initial window (and the offscreen frame) size in tiles
 	const size_t TILES_X_COUNT = 8;
 	const size_t TILES_Y_COUNT = 6;
 	const size_t SCREEN_W = TILES_X_COUNT * TILE_SIDE;
 	const size_t SCREEN_H = TILES_Y_COUNT * TILE_SIDE;
-	const size_t MORSE_SIDE = TILE_SIDE / 10;
+
+	const SDL_Color LINE_COLOR       = {255, 0, 255, 255};
+	const SDL_Color BACKGROUND_COLOR = {  0, 0,   0,   0};
+
+	// Offscreen video
+	const unsigned FRAMES_PER_SECOND = 25;
+
+	// Anti-aliased dots and crosses, they look better scaled up
+	const bool SMOOTH_GLYPHS = true;
 
 	// MySDL::Renderer wrapper
 	class MorseRenderer
@@ -24,16 +44,14 @@ namespace morse_graphic_renderer
 
 	public:
 		MorseRenderer() :
-			window_ (SDL_CreateWindow("SDL_RENDERER", 50, 50, SCREEN_W, SCREEN_H, SDL_WINDOW_SHOWN)),
-			renderer_ (window_)
+			window_ (SDL_CreateWindow("SDL_RENDERER", 50, 50, SCREEN_W, SCREEN_H, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE)),
+			// Presenting waits for the display refresh, so frames are paced by the display
+			renderer_ (window_, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)
 		{
 			if (window_ == nullptr)
 			{
-				throw Exception(ArgMsg("Main: Can not create a window, %s", SDL_GetError()));
+				throw Exception(VAEXC_MSG("Main: Can not create a window, %s", SDL_GetError()));
 			}
-
-			renderer_.setLineColor({255, 0, 255, 255});
-			renderer_.setFillColor({  0, 0,   0,   0});
 		}
 
 		~MorseRenderer()
@@ -45,110 +63,360 @@ namespace morse_graphic_renderer
 
 	};
 
+	// SDL wants video, its windows and event pumping on one thread: the windowed renderer's own.
+	// It's the only one touching video, so init and quit don't race (audio is done by main() around the pipeline).
 	void MorseGraphicsInit()
 	{
-		if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
+		if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0)
 		{
-			throw Exception("Can't initialize SDL"_msg, VAEXC_POS);
+			throw Exception(VAEXC_MSG("Can't initialize SDL video: %s", SDL_GetError()), VAEXC_POS);
 		}
 	}
 
 	void MorseGraphicsQuit()
 	{
-		SDL_Quit();
+		SDL_QuitSubSystem(SDL_INIT_VIDEO);
 	}
 
-	void MorseGraphicsRender(MorseSymbol morseSymbol)
+	// The grid of tiles on a screen
+	struct TileLayout
 	{
-		// MorseRender to render with
-		static MorseRenderer renderer{};
-
-		// A queue to store previous morse symbols
-		static VaQueue::Queue<MorseSymbol, TILES_X_COUNT * TILES_Y_COUNT> lastElements{};
+		size_t side;
+		size_t columns;
+		size_t rows;
 
-		if (lastElements.size() == lastElements.capasity())
+		// As many tiles of at least TILE_SIDE as fit, made as big as the screen allows
+		static TileLayout fit(size_t screenW, size_t screenH)
 		{
-			lastElements.pop_front();
+			size_t columns = std::max<size_t>(screenW / TILE_SIDE, 1);
+			size_t rows    = std::max<size_t>(screenH / TILE_SIDE, 1);
+			size_t side    = std::max<size_t>(std::min(screenW / columns, screenH / rows), 1);
+
+			return {side, columns, rows};
 		}
 
-		if (morseSymbol != '_') lastElements.push_back(morseSymbol);
+		size_t tileCount() const { return columns * rows; }
+	};
+
+	// Shows last morse symbols, one tile per symbol, in a window or (headless) as a stream of video frames
+	class MorseGraphicRenderer : public MorseRendererInterface
+	{
+	private:
+		// Window mode: MorseRender to render with, lives on the render thread
+		std::unique_ptr<MorseRenderer> window_;
+
+		// Offscreen mode: frames of FRAMES_PER_SECOND video time go to framePath_
+		std::string                               framePath_;
+		MySDL::FrameFormat                        frameFormat_;
+		std::unique_ptr<MySDL::FrameWriter>       writer_;
+		std::unique_ptr<MySDL::OffscreenRenderer> offscreen_;
+
+		bool                   videoStarted_;
+		MorseClock::time_point firstFrame_;    // Video time 0, the start of the first element
+		MorseClock::time_point lastEnd_;       // The end of the last element
+		size_t                 framesWritten_;
+
+		// The window or the offscreen renderer
+		MySDL::FrameTarget* target_;
+
+		// Rasterization workers, one per hardware thread
+		std::unique_ptr<MySDL::ThreadPool> pool_;
+
+		// The grid for the current size of the target
+		TileLayout layout_;
+
+		// Previous morse symbols, as many as there are tiles at most
+		std::deque<MorseSymbol> lastElements_;
 
-		// Rendering queue:
+		// The texture is a ring of tile rows: this one is shown at the top of the window
+		size_t topRow_;
 
-		renderer.getRenderer().startRendering();
-		renderer.getRenderer().clear({0, 0, 0, 0});
+		// Symbols drawn once, copied into the tiles
+		MorseGlyphAtlas atlas_;
 
-		for (size_t i = 0; i < lastElements.size(); ++i)
+		// The texture has changed since the last frame
+		bool frameChanged_;
+
+		// Where the symbol with this index in lastElements_ is in the texture
+		SDL_Rect tileRect(size_t index) const;
+
+		void showFrame();
+
+		// Lays the tiles out for the current target size and redraws all of them, the glyphs are rebuilt only for a new tile side
+		void relayout();
+
+		// Window mode: reallocates and relayouts only when the window size has actually changed
+		bool followWindowSize();
+
+		// Offscreen: writes the frames due before the moment, showing what is drawn now
+		void writeFramesUntil(MorseClock::time_point moment);
+
+		Status MorseGraphicsRender(MorseSymbol morseSymbol);
+
+	public:
+		// With a frame path nothing is shown on screen, frames are written there ("-" for stdout)
+		explicit MorseGraphicRenderer(const std::string& framePath = "", MySDL::FrameFormat frameFormat = MySDL::FrameFormat::Ppm) :
+			window_        (),
+			framePath_     (framePath),
+			frameFormat_   (frameFormat),
+			writer_        (),
+			offscreen_     (),
+			videoStarted_  (false),
+			firstFrame_    (),
+			lastEnd_       (),
+			framesWritten_ (0),
+			target_        (nullptr),
+			pool_          (),
+			layout_        (),
+			lastElements_  (),
+			topRow_        (0),
+			atlas_         (),
+			frameChanged_  (false)
+		{}
+
+		void init() override
 		{
-			int curX = (i % TILES_X_COUNT) * TILE_SIDE + TILE_SIDE / 2;
-			int curY = (i / TILES_X_COUNT) * TILE_SIDE + TILE_SIDE / 2;
+			if (framePath_.empty())
+			{
+				MorseGraphicsInit();
+
+				window_.reset(new MorseRenderer{});
 
-			switch (lastElements.at(i))
+				target_ = &window_->getRenderer();
+			}
+			else
 			{
-				case '.':
-				{
-					renderer.getRenderer().circle(curX, curY, TILE_SIDE/10);
-					break;
-				}
-				case '-':
-				{
-					// Drawing rectangle
-					renderer.getRenderer().line(curX - 3 * MORSE_SIDE, curY - MORSE_SIDE,
-					                            curX - 3 * MORSE_SIDE, curY + MORSE_SIDE);
-					renderer.getRenderer().line(curX + 3 * MORSE_SIDE, curY - MORSE_SIDE,
-					                            curX + 3 * MORSE_SIDE, curY + MORSE_SIDE);
-					renderer.getRenderer().line(curX - 3 * MORSE_SIDE, curY - MORSE_SIDE,
-					                            curX + 3 * MORSE_SIDE, curY - MORSE_SIDE);
-					renderer.getRenderer().line(curX - 3 * MORSE_SIDE, curY + MORSE_SIDE,
-					                            curX + 3 * MORSE_SIDE, curY + MORSE_SIDE);
-					break;
-				}
-				case ' ':
-				{
-					// Drawing underscore
-					renderer.getRenderer().line(curX - 3 * MORSE_SIDE, curY + 3 * MORSE_SIDE,
-					                            curX + 3 * MORSE_SIDE, curY + 3 * MORSE_SIDE);
-					break;
-				}
-				case '<':
-				{
-					break;
-				}
-				case '!':
-				{
-					renderer.getRenderer().line(curX - 3 * MORSE_SIDE, curY - 3 * MORSE_SIDE,
-					                            curX + 3 * MORSE_SIDE, curY + 3 * MORSE_SIDE);
-					renderer.getRenderer().line(curX - 3 * MORSE_SIDE, curY + 3 * MORSE_SIDE,
-					                            curX + 3 * MORSE_SIDE, curY - 3 * MORSE_SIDE);
-					break;
-				}
-				default:
+				writer_   .reset(new MySDL::FrameWriter{framePath_, frameFormat_});
+				offscreen_.reset(new MySDL::OffscreenRenderer{SCREEN_W, SCREEN_H, writer_.get()});
+
+				target_ = offscreen_.get();
+			}
+
+			pool_.reset(new MySDL::ThreadPool{});
+
+			target_->setLineColor(LINE_COLOR);
+			target_->setFillColor(BACKGROUND_COLOR);
+			target_->setThreadPool(pool_.get());
+
+			// Frames redraw only what has changed, so the rest has to be defined from the start
+			relayout();
+		}
+
+		void render(const MorseElement& element) override
+		{
+			tryRender(element).raiseIfFailed();
+		}
+
+		// Only updates the texture, all symbols of a frame are shown by present()
+		Status tryRender(const MorseElement& element) override
+		{
+			if (offscreen_)
+			{
+				if (!videoStarted_)
 				{
-					throw Exception(ArgMsg("Invalid morse symbol: (%c)", lastElements.at(i)), VAEXC_POS);
+					firstFrame_   = element.start;
+					videoStarted_ = true;
 				}
+
+				writeFramesUntil(element.start);
+
+				lastEnd_ = element.start + std::chrono::milliseconds(element.units * MORSE_TIME_UNIT);
+			}
+
+			return MorseGraphicsRender(element.symbol);
+		}
+
+		void present() override
+		{
+			// Offscreen frames follow the element times, not the rendering
+			if (offscreen_) return;
+
+			SDL_PumpEvents();
+
+			followWindowSize();
+
+			if (frameChanged_)
+			{
+				showFrame();
+
+				frameChanged_ = false;
+			}
+		}
+
+		void idle() override
+		{
+			// Keeps the window responsive, a resized one gets its new frame without waiting for symbols
+			if (!window_) return;
+
+			SDL_PumpEvents();
+
+			if (followWindowSize())
+			{
+				showFrame();
+
+				frameChanged_ = false;
 			}
 		}
 
-		renderer.getRenderer().finishRendering();
-		renderer.getRenderer().flash();
+		void quit() override
+		{
+			if (offscreen_)
+			{
+				// The last element is shown till its end
+				writeFramesUntil(lastEnd_);
+
+				writer_->flush();
+			}
+
+			target_ = nullptr;
+
+			offscreen_.reset();
+			writer_   .reset();
+
+			window_.reset();
+
+			// Also after a failed init(): quitting video that isn't initialized does nothing
+			if (framePath_.empty()) MorseGraphicsQuit();
+
+			pool_.reset();
+		}
+	};
+
+	SDL_Rect MorseGraphicRenderer::tileRect(size_t index) const
+	{
+		size_t row = (topRow_ + index / layout_.columns) % layout_.rows;
+
+		return {static_cast<int>((index % layout_.columns) * layout_.side), static_cast<int>(row * layout_.side),
+		        static_cast<int>(layout_.side), static_cast<int>(layout_.side)};
+	}
+
+	void MorseGraphicRenderer::showFrame()
+	{
+		int screenW = static_cast<int>(target_->getDestSizeX());
+		int screenH = static_cast<int>(target_->getDestSizeY());
+
+		// Rows from topRow_ down go to the top of the window, the rows above it follow them.
+		// The strip below the rows (the leftover of the tiles) stays where it is.
+		int ringH   = static_cast<int>(layout_.rows * layout_.side);
+		int topH    = static_cast<int>((layout_.rows - topRow_) * layout_.side);
+		int bottomH = ringH - topH;
+
+		SDL_Rect srcs[3]  = {{0, bottomH, screenW, topH}, {0, 0,    screenW, bottomH}, {0, ringH, screenW, screenH - ringH}};
+		SDL_Rect dests[3] = {{0, 0,       screenW, topH}, {0, topH, screenW, bottomH}, {0, ringH, screenW, screenH - ringH}};
+
+		size_t count = 0;
+
+		for (size_t i = 0; i < 3; ++i)
+		{
+			if (srcs[i].h == 0) continue;
+
+			srcs [count] = srcs [i];
+			dests[count] = dests[i];
+
+			++count;
+		}
+
+		target_->present(srcs, dests, count);
+	}
+
+	void MorseGraphicRenderer::relayout()
+	{
+		MORSE_TRACE_SCOPE("relayout");
+
+		layout_ = TileLayout::fit(target_->getDestSizeX(), target_->getDestSizeY());
+
+		atlas_.prepare(static_cast<unsigned>(layout_.side), LINE_COLOR, BACKGROUND_COLOR, SMOOTH_GLYPHS);
+
+		// The newest symbols that fit, from the top left tile on
+		while (lastElements_.size() > layout_.tileCount()) lastElements_.pop_front();
+
+		topRow_ = 0;
+
+		MySDL::FrameTarget& renderer = *target_;
+
+		renderer.startRendering();
+		renderer.clear(BACKGROUND_COLOR);
+
+		for (size_t index = 0; index < lastElements_.size(); ++index)
+		{
+			SDL_Rect tile = tileRect(index);
+
+			atlas_.blit(renderer, lastElements_[index], tile.x, tile.y);
+		}
+
+		renderer.finishRendering();
+
+		frameChanged_ = true;
+	}
+
+	bool MorseGraphicRenderer::followWindowSize()
+	{
+		if (!window_ || !window_->getRenderer().fitWindow()) return false;
+
+		relayout();
+
+		return true;
+	}
 
-		// Waiting after rendering:
-		switch (morseSymbol)
+	void MorseGraphicRenderer::writeFramesUntil(MorseClock::time_point moment)
+	{
+		if (!videoStarted_ || moment <= firstFrame_) return;
+
+		// Frame n shows the moment firstFrame_ + n / FRAMES_PER_SECOND
+		auto   since = std::chrono::duration_cast<std::chrono::microseconds>(moment - firstFrame_).count();
+		size_t due   = static_cast<size_t>((since * FRAMES_PER_SECOND + 999999) / 1000000);
+
+		for (; framesWritten_ < due; ++framesWritten_) showFrame();
+	}
+
+	Status MorseGraphicRenderer::MorseGraphicsRender(MorseSymbol morseSymbol)
+	{
+		MORSE_TRACE_SCOPE("MorseGraphicsRender");
+
+		if (morseSymbol == '_') return {};
+
+		// Invalid symbols fail before they get stored
+		Expected<const Uint32*> glyph = atlas_.findGlyph(morseSymbol);
+		if (!glyph.ok()) return glyph.status();
+
+		// Scrolling: the oldest row goes away, its texture row becomes the new bottom row
+		if (lastElements_.size() == layout_.tileCount())
 		{
-			case '.': return SDL_Delay(1 * MORSE_TIME_UNIT);
-			case '-': return SDL_Delay(3 * MORSE_TIME_UNIT);
-			case '_': return SDL_Delay(1 * MORSE_TIME_UNIT);
-			case ' ': return SDL_Delay(3 * MORSE_TIME_UNIT);
-			case '<': return SDL_Delay(7 * MORSE_TIME_UNIT);
-			case '!': return SDL_Delay(3 * MORSE_TIME_UNIT);
-			default:  return;
+			for (size_t i = 0; i < layout_.columns; ++i) lastElements_.pop_front();
+
+			topRow_ = (topRow_ + 1) % layout_.rows;
 		}
+
+		lastElements_.push_back(morseSymbol);
+
+		// Damage: the new tile; the first symbol of a row clears the whole row, it may hold a scrolled out one.
+		// Glyphs cover their tiles completely, so nothing else has to be cleared.
+
+		MySDL::FrameTarget& renderer = *target_;
+
+		size_t   index = lastElements_.size() - 1;
+		SDL_Rect tile  = tileRect(index);
+
+		if (index % layout_.columns == 0)
+		{
+			renderer.startRendering({0, tile.y, static_cast<int>(renderer.getDestSizeX()), tile.h});
+			renderer.clear(BACKGROUND_COLOR);
+		}
+		else renderer.startRendering(tile);
+
+		atlas_.blit(renderer, morseSymbol, tile.x, tile.y);
+
+		renderer.finishRendering();
+
+		frameChanged_ = true;
+
+		return {};
 	}
 
 }  // namespace morse_graphic_renderer
 
-using morse_graphic_renderer::MorseGraphicsRender;
-using morse_graphic_renderer::MorseGraphicsInit  ;
-using morse_graphic_renderer::MorseGraphicsQuit  ;
+using morse_graphic_renderer::MorseGraphicRenderer;
+using morse_graphic_renderer::MorseGraphicsInit   ;
+using morse_graphic_renderer::MorseGraphicsQuit   ;
 
 #endif  // HEADER_GUARD_BOOP_BEEPER_RENDERER_GRAPHIC_HPP_INCLUDED
\ No newline at end of file
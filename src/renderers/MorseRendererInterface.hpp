@@ -0,0 +1,40 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_RENDERER_INTERFACE_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_RENDERER_INTERFACE_HPP_INCLUDED
+
+#include "../Morse.hpp"
+
+#include "../queue/VaException.hpp"
+
+// Everything that shows morse elements: console, window, speakers.
+// All functions are called on the render thread of the renderer.
+class MorseRendererInterface
+{
+public:
+	virtual ~MorseRendererInterface() = default;
+
+	// Before the first element
+	virtual void init() {}
+
+	// Shows the element; the schedule is kept by the caller, so it must not wait for the slot to end
+	virtual void render(const MorseElement& element) = 0;
+
+	// render() that reports a bad element as a Status instead of throwing, the render loop calls this one
+	virtual VaExc::Status tryRender(const MorseElement& element)
+	{
+		render(element);
+
+		return {};
+	}
+
+	// After the elements that have arrived by now are rendered, so they can be shown as one frame.
+	// May wait for the display (vsync): elements coming meanwhile go into the next frame.
+	virtual void present() {}
+
+	// When there are no elements to show (e.g. to keep a window responsive)
+	virtual void idle() {}
+
+	// After the last element
+	virtual void quit() {}
+};
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_RENDERER_INTERFACE_HPP_INCLUDED
\ No newline at end of file
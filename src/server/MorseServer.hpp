@@ -0,0 +1,614 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_SERVER_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_SERVER_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../queue/VaException.hpp"
+
+#include "../Morse.hpp"
+
+#include "TimerWheel.hpp"
+
+// Serves many clients from one process: every connection on the unix socket is an
+// independent session, whose text is encoded and streamed back as timed morse symbols.
+// A few worker threads each run an epoll loop with a timer wheel for symbol deadlines.
+namespace morse_server
+{
+	using namespace VaExc;
+
+	// Server constants:
+	const unsigned TICK           = 10; // milliseconds
+	const unsigned TICKS_PER_UNIT = MORSE_TIME_UNIT / TICK;
+
+	const size_t READ_BLOCK_SIZE   = 4096;
+	const size_t MAX_PENDING       = 1 << 16; // symbols, reading pauses above that
+	const size_t MAX_UNSENT        = 1 << 16; // bytes, a client that doesn't read gets dropped
+	const int    MAX_EVENTS        = 256;
+	const int    IDLE_POLL_TIMEOUT = 100;     // milliseconds, how fast a stop request is noticed
+
+	// What the client receives for a symbol:
+	const char* morseSymbolText(MorseSymbol morseSymbol)
+	{
+		switch (morseSymbol)
+		{
+			case '.': return ".";
+			case '-': return "-";
+			case ' ': return " ";
+			case '<': return "\n";
+			case '!': return "!";
+			default:  return "";
+		}
+	}
+
+	//-----------------------------------------------------------
+	// Session:
+	//-----------------------------------------------------------
+
+	struct Session
+	{
+		int fd;
+
+		MorseEncoder encoder;
+
+		std::string pending;     // Encoded, not yet shown symbols
+		size_t      pendingBeg;
+
+		std::string unsent;      // Shown symbols the socket didn't take yet
+
+		uint64_t nextSlot;       // Tick at which the next symbol starts
+		uint64_t timerGeneration; // Of the armed timer, stamped by the worker
+		bool     timerArmed;
+
+		bool inputClosed;
+		bool reading;
+		bool writing;
+
+		explicit Session(int socket) :
+			fd              (socket),
+			encoder         (),
+			pending         (),
+			pendingBeg      (0),
+			unsent          (),
+			nextSlot        (0),
+			timerGeneration (0),
+			timerArmed      (false),
+			inputClosed     (false),
+			reading         (true),
+			writing         (false)
+		{}
+
+		size_t pendingSize() const { return pending.size() - pendingBeg; }
+	};
+
+	// Counters of a worker:
+	struct WorkerStats
+	{
+		std::atomic<uint64_t> accepted;
+		std::atomic<uint64_t> closed;
+		std::atomic<uint64_t> symbols;
+		std::atomic<uint64_t> dropped;
+
+		WorkerStats() :
+			accepted (0),
+			closed   (0),
+			symbols  (0),
+			dropped  (0)
+		{}
+	};
+
+	//-----------------------------------------------------------
+	// Worker: one thread, one epoll, one timer wheel
+	//-----------------------------------------------------------
+
+	class Worker
+	{
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		// Variables:
+			int listener_;
+			int epoll_;
+
+			std::atomic<bool>& stopped_;
+
+			std::unordered_map<int, std::unique_ptr<Session>> sessions_;
+
+			Clock::time_point started_;
+			TimerWheel        wheel_;
+
+			// Timers are keyed by fd and fds get reused, so generations are never reused across sessions
+			uint64_t timerGeneration_;
+
+			WorkerStats stats_;
+
+			std::string error_;
+			std::thread thread_;
+
+		// Helpers:
+			uint64_t nowTick() const
+			{
+				return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started_).count() / TICK;
+			}
+
+			void updateEvents(Session& session)
+			{
+				// EPOLLRDHUP is level-triggered, it's only wanted while reading
+				uint32_t readEvents  = session.reading ? EPOLLIN | EPOLLRDHUP : 0;
+				uint32_t writeEvents = session.writing ? static_cast<uint32_t>(EPOLLOUT) : 0;
+
+				epoll_event event{};
+				event.events  = readEvents | writeEvents;
+				event.data.fd = session.fd;
+
+				epoll_ctl(epoll_, EPOLL_CTL_MOD, session.fd, &event);
+			}
+
+			void closeSession(int fd)
+			{
+				epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+				close(fd);
+
+				sessions_.erase(fd);
+
+				stats_.closed.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			void armTimer(Session& session)
+			{
+				session.timerGeneration = ++timerGeneration_;
+				session.timerArmed      = true;
+
+				wheel_.schedule(session.nextSlot, session.fd, session.timerGeneration);
+			}
+
+			// Returns false if the session is gone
+			bool flush(Session& session)
+			{
+				while (!session.unsent.empty())
+				{
+					ssize_t sent = send(session.fd, session.unsent.data(), session.unsent.size(), MSG_NOSIGNAL);
+
+					if (sent < 0 && errno == EINTR) continue;
+
+					if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+					if (sent < 0)
+					{
+						closeSession(session.fd);
+						return false;
+					}
+
+					session.unsent.erase(0, static_cast<size_t>(sent));
+				}
+
+				if (session.unsent.size() > MAX_UNSENT)
+				{
+					stats_.dropped.fetch_add(1, std::memory_order_relaxed);
+
+					closeSession(session.fd);
+					return false;
+				}
+
+				bool wantWrite = !session.unsent.empty();
+
+				if (wantWrite != session.writing)
+				{
+					session.writing = wantWrite;
+					updateEvents(session);
+				}
+
+				return true;
+			}
+
+			bool finished(const Session& session) const
+			{
+				return session.inputClosed && session.pendingSize() == 0 && !session.timerArmed && session.unsent.empty();
+			}
+
+		// Events:
+			void acceptAll()
+			{
+				while (true)
+				{
+					int fd = accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+					if (fd < 0)
+					{
+						if (errno == EINTR) continue;
+
+						// EAGAIN: another worker took it or the backlog is empty
+						return;
+					}
+
+					epoll_event event{};
+					event.events  = EPOLLIN | EPOLLRDHUP;
+					event.data.fd = fd;
+
+					if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) != 0)
+					{
+						close(fd);
+						continue;
+					}
+
+					sessions_[fd].reset(new Session{fd});
+
+					stats_.accepted.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+
+			void readSession(Session& session)
+			{
+				char block[READ_BLOCK_SIZE];
+
+				while (session.reading)
+				{
+					ssize_t got = read(session.fd, block, sizeof(block));
+
+					if (got < 0 && errno == EINTR) continue;
+					if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+					if (got <= 0)
+					{
+						session.inputClosed = true;
+						session.reading     = false;
+
+						updateEvents(session);
+						break;
+					}
+
+					for (ssize_t i = 0; i < got; ++i)
+					{
+						session.encoder.encode(block[i], [&session] (MorseSymbol symbol) { session.pending.push_back(symbol); });
+					}
+
+					if (session.pendingSize() > MAX_PENDING)
+					{
+						session.reading = false;
+
+						updateEvents(session);
+					}
+				}
+
+				// An idle session starts its schedule over from now
+				if (!session.timerArmed && session.pendingSize() != 0)
+				{
+					if (session.nextSlot <= wheel_.currentTick()) session.nextSlot = wheel_.currentTick() + 1;
+
+					armTimer(session);
+				}
+
+				if (finished(session)) closeSession(session.fd);
+			}
+
+			// Deadline of a session: its next symbol is due
+			void fireTimer(const TimerWheel::Timer& timer)
+			{
+				auto found = sessions_.find(timer.id);
+				if (found == sessions_.end()) return;
+
+				Session& session = *found->second;
+				if (session.timerGeneration != timer.generation) return;
+
+				session.timerArmed = false;
+
+				if (session.pendingSize() == 0)
+				{
+					if (finished(session)) closeSession(session.fd);
+					return;
+				}
+
+				MorseSymbol symbol = session.pending[session.pendingBeg++];
+
+				if (session.pendingBeg == session.pending.size())
+				{
+					session.pending.clear();
+					session.pendingBeg = 0;
+				}
+
+				session.unsent += morseSymbolText(symbol);
+
+				stats_.symbols.fetch_add(1, std::memory_order_relaxed);
+
+				// Deadlines follow the schedule, not the moment the timer fired, so they don't drift
+				session.nextSlot = timer.tick + morseSymbolUnits(symbol) * TICKS_PER_UNIT;
+
+				if (!flush(session)) return;
+
+				// The last symbol keeps its slot, finished() is checked when it ends
+				armTimer(session);
+
+				if (!session.reading && !session.inputClosed && session.pendingSize() < MAX_PENDING / 2)
+				{
+					session.reading = true;
+
+					updateEvents(session);
+				}
+			}
+
+			void run()
+			{
+				epoll_event events[MAX_EVENTS];
+
+				while (!stopped_.load(std::memory_order_relaxed))
+				{
+					int timeout = IDLE_POLL_TIMEOUT;
+
+					if (wheel_.size() != 0)
+					{
+						auto sinceStart = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started_).count();
+
+						timeout = static_cast<int>((wheel_.currentTick() + 1) * TICK - sinceStart);
+						if (timeout < 0) timeout = 0;
+					}
+
+					int ready = epoll_wait(epoll_, events, MAX_EVENTS, timeout);
+
+					if (ready < 0 && errno != EINTR)
+					{
+						throw Exception(VAEXC_MSG("Server: epoll_wait failed: %s", std::strerror(errno)), VAEXC_POS);
+					}
+
+					for (int i = 0; i < ready; ++i)
+					{
+						int fd = events[i].data.fd;
+
+						if (fd == listener_)
+						{
+							acceptAll();
+							continue;
+						}
+
+						auto found = sessions_.find(fd);
+						if (found == sessions_.end()) continue;
+
+						Session& session = *found->second;
+
+						if (events[i].events & (EPOLLERR | EPOLLHUP))
+						{
+							closeSession(fd);
+							continue;
+						}
+
+						if (events[i].events & EPOLLOUT)
+						{
+							if (!flush(session)) continue;
+
+							if (finished(session))
+							{
+								closeSession(fd);
+								continue;
+							}
+						}
+
+						if (events[i].events & (EPOLLIN | EPOLLRDHUP)) readSession(session);
+					}
+
+					wheel_.advance(nowTick(), [this] (const TimerWheel::Timer& timer) { fireTimer(timer); });
+				}
+
+				for (auto& session : sessions_) close(session.first);
+
+				sessions_.clear();
+			}
+
+	public:
+		// Ctor && dtor:
+			Worker(int listener, std::atomic<bool>& stopped) :
+				listener_        (listener),
+				epoll_           (epoll_create1(EPOLL_CLOEXEC)),
+				stopped_         (stopped),
+				sessions_        (),
+				started_         (Clock::now()),
+				wheel_           (0),
+				timerGeneration_ (0),
+				stats_           (),
+				error_           (),
+				thread_          ()
+			{
+				if (epoll_ < 0)
+				{
+					throw Exception(VAEXC_MSG("Server: epoll_create1 failed: %s", std::strerror(errno)), VAEXC_POS);
+				}
+
+				// Every worker waits on the listener, the kernel wakes only one of them per connection
+				epoll_event event{};
+				event.events  = EPOLLIN | EPOLLEXCLUSIVE;
+				event.data.fd = listener_;
+
+				if (epoll_ctl(epoll_, EPOLL_CTL_ADD, listener_, &event) != 0)
+				{
+					close(epoll_);
+
+					throw Exception(VAEXC_MSG("Server: can't watch the listener: %s", std::strerror(errno)), VAEXC_POS);
+				}
+			}
+
+			~Worker()
+			{
+				join();
+
+				close(epoll_);
+			}
+
+			Worker           (const Worker&) = delete;
+			Worker& operator=(const Worker&) = delete;
+
+		// Thread control:
+			void start()
+			{
+				thread_ = std::thread
+				{
+					[this]
+					{
+						try
+						{
+							run();
+						}
+						catch (VaExc::Exception& exc)
+						{
+							error_ = exc.what();
+							stopped_.store(true);
+						}
+						catch (std::exception& exc)
+						{
+							error_ = exc.what();
+							stopped_.store(true);
+						}
+						catch (...)
+						{
+							error_ = "Unexpected exception";
+							stopped_.store(true);
+						}
+					}
+				};
+			}
+
+			void join()
+			{
+				if (thread_.joinable()) thread_.join();
+			}
+
+		// Getters:
+			const WorkerStats& stats() const { return stats_; }
+
+			const std::string& error() const { return error_; }
+	};
+
+	//-----------------------------------------------------------
+	// The server itself:
+	//-----------------------------------------------------------
+
+	class MorseServer
+	{
+	private:
+		// Variables:
+			std::string path_;
+			int         listener_;
+
+			std::atomic<bool> stopped_;
+
+			std::vector<std::unique_ptr<Worker>> workers_;
+
+	public:
+		// Ctor && dtor:
+			MorseServer(const std::string& path, size_t workerCount) :
+				path_     (path),
+				listener_ (socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)),
+				stopped_  (false),
+				workers_  ()
+			{
+				if (listener_ < 0)
+				{
+					throw Exception(VAEXC_MSG("Server: can't create a socket: %s", std::strerror(errno)), VAEXC_POS);
+				}
+
+				sockaddr_un address{};
+				address.sun_family = AF_UNIX;
+
+				if (path_.size() >= sizeof(address.sun_path))
+				{
+					close(listener_);
+
+					throw Exception(VAEXC_MSG("Server: socket path is too long: %s", path_.c_str()), VAEXC_POS);
+				}
+
+				std::strcpy(address.sun_path, path_.c_str());
+
+				// A stale socket file of a previous run
+				unlink(path_.c_str());
+
+				if (bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+				    listen(listener_, SOMAXCONN) != 0)
+				{
+					close(listener_);
+
+					throw Exception(VAEXC_MSG("Server: can't listen on %s: %s", path_.c_str(), std::strerror(errno)), VAEXC_POS);
+				}
+
+				if (workerCount == 0) workerCount = 1;
+
+				for (size_t i = 0; i < workerCount; ++i) workers_.emplace_back(new Worker{listener_, stopped_});
+			}
+
+			~MorseServer()
+			{
+				stop();
+				join();
+
+				workers_.clear();
+
+				close(listener_);
+				unlink(path_.c_str());
+			}
+
+			MorseServer           (const MorseServer&) = delete;
+			MorseServer& operator=(const MorseServer&) = delete;
+
+		// Thread control:
+			void start()
+			{
+				for (auto& worker : workers_) worker->start();
+			}
+
+			// Safe to call from another thread
+			void stop() { stopped_.store(true); }
+
+			bool stopped() const { return stopped_.load(); }
+
+			void join()
+			{
+				for (auto& worker : workers_) worker->join();
+			}
+
+		// Getters:
+			std::vector<std::string> errors() const
+			{
+				std::vector<std::string> result;
+
+				for (auto& worker : workers_)
+				{
+					if (!worker->error().empty()) result.push_back(worker->error());
+				}
+
+				return result;
+			}
+
+		// Debugging:
+			void dumpStats(std::ostream& out) const
+			{
+				out << "worker  accepted    closed   symbols   dropped\n";
+
+				for (size_t i = 0; i < workers_.size(); ++i)
+				{
+					const WorkerStats& stats = workers_[i]->stats();
+
+					out << std::left  << std::setw(6) << i
+					    << std::right << std::setw(10) << stats.accepted.load()
+					    << std::setw(10) << stats.closed  .load()
+					    << std::setw(10) << stats.symbols .load()
+					    << std::setw(10) << stats.dropped .load() << "\n";
+				}
+			}
+	};
+
+}  // namespace morse_server
+
+using morse_server::MorseServer;
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_SERVER_HPP_INCLUDED
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_TIMER_WHEEL_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_TIMER_WHEEL_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace morse_server
+{
+	// Hashed timer wheel: O(1) scheduling, expiry costs O(timers due) per tick.
+	// Deadlines further than one turn away just stay in their slot for extra turns.
+	// Timers can't be cancelled, owners recognise stale ones by the generation.
+	class TimerWheel
+	{
+	public:
+		struct Timer
+		{
+			uint64_t tick;
+			int      id;
+			uint64_t generation;
+		};
+
+	private:
+		static const size_t SLOT_COUNT = 256;
+
+		// Variables:
+			std::vector<Timer> slots_[SLOT_COUNT];
+
+			uint64_t curTick_;
+			size_t   size_;
+
+	public:
+		explicit TimerWheel(uint64_t startTick) :
+			slots_   (),
+			curTick_ (startTick),
+			size_    (0)
+		{}
+
+		uint64_t currentTick() const { return curTick_; }
+
+		size_t size() const { return size_; }
+
+		// Deadlines in the past fire on the next tick
+		void schedule(uint64_t tick, int id, uint64_t generation)
+		{
+			if (tick <= curTick_) tick = curTick_ + 1;
+
+			slots_[tick % SLOT_COUNT].push_back({tick, id, generation});
+
+			++size_;
+		}
+
+		// Calls fire(const Timer&) for every timer due by nowTick; fire may schedule new timers
+		template <typename Fire>
+		void advance(uint64_t nowTick, Fire&& fire)
+		{
+			if (nowTick <= curTick_) return;
+
+			uint64_t steps = nowTick - curTick_;
+			if (steps > SLOT_COUNT) steps = SLOT_COUNT;
+
+			std::vector<Timer> due;
+
+			for (uint64_t step = 1; step <= steps; ++step)
+			{
+				std::vector<Timer>& slot = slots_[(curTick_ + step) % SLOT_COUNT];
+
+				size_t kept = 0;
+
+				for (size_t i = 0; i < slot.size(); ++i)
+				{
+					if (slot[i].tick <= nowTick) due.push_back(slot[i]);
+					else slot[kept++] = slot[i];
+				}
+
+				slot.resize(kept);
+			}
+
+			curTick_ = nowTick;
+			size_   -= due.size();
+
+			for (const Timer& timer : due) fire(timer);
+		}
+	};
+
+}  // namespace morse_server
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_TIMER_WHEEL_HPP_INCLUDED
\ No newline at end of file
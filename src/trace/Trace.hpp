@@ -0,0 +1,321 @@
+#ifndef HEADER_GUARD_BOOP_BEEPER_TRACE_HPP_INCLUDED
+#define HEADER_GUARD_BOOP_BEEPER_TRACE_HPP_INCLUDED
+
+// Timeline tracing, exported as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Built in only with -DMORSE_TRACE; without it every MORSE_TRACE_* macro expands to nothing
+// and no tracing code or data is left in the program.
+//
+// Every thread records fixed-size events into its own lock-free ring; a background thread
+// drains the rings and writes the JSON, so the traced threads never format or do I/O.
+// Event names have to be string literals (or live as long as the program).
+
+#ifdef MORSE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../queue/VaException.hpp"
+
+namespace morse_trace
+{
+	const bool COMPILED_IN = true;
+
+	// Events per thread, waiting to be written; a full ring drops new events (and counts them)
+	const size_t RING_SIZE = 1 << 14;
+
+	// How often the rings are drained
+	const unsigned FLUSH_PERIOD = 50; // milliseconds
+
+	using Clock = std::chrono::steady_clock;
+
+	struct TraceEvent
+	{
+		const char* name;
+		char        phase;    // 'X' complete (a scope), 'i' instant, 'C' counter
+		uint64_t    start;    // ns since the tracer started
+		uint64_t    duration; // ns, complete events only
+		int64_t     value;    // Counters only
+	};
+
+	// Single producer (the owning thread), single consumer (the flusher)
+	class TraceRing
+	{
+	private:
+		TraceEvent events_[RING_SIZE];
+
+		std::atomic<size_t> head_; // Next to write, owned by the producer
+		std::atomic<size_t> tail_; // Next to read, owned by the consumer
+
+	public:
+		const size_t id;
+
+		std::string           threadName;
+		std::atomic<uint64_t> dropped;
+
+		explicit TraceRing(size_t ringId) :
+			events_    (),
+			head_      (0),
+			tail_      (0),
+			id         (ringId),
+			threadName (),
+			dropped    (0)
+		{}
+
+		void push(const TraceEvent& event)
+		{
+			size_t head = head_.load(std::memory_order_relaxed);
+
+			if (head - tail_.load(std::memory_order_acquire) == RING_SIZE)
+			{
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			events_[head % RING_SIZE] = event;
+
+			head_.store(head + 1, std::memory_order_release);
+		}
+
+		template <typename Consumer>
+		void drain(Consumer&& consumer)
+		{
+			size_t tail = tail_.load(std::memory_order_relaxed);
+			size_t head = head_.load(std::memory_order_acquire);
+
+			for (; tail != head; ++tail) consumer(events_[tail % RING_SIZE]);
+
+			tail_.store(tail, std::memory_order_release);
+		}
+	};
+
+	class Tracer
+	{
+	private:
+		std::atomic<bool> recording_;
+		Clock::time_point epoch_;
+
+		std::mutex                              ringsMutex_;
+		std::vector<std::unique_ptr<TraceRing>> rings_;
+
+		FILE*       file_;
+		bool        firstEvent_;
+		std::thread flusher_;
+
+		void writeEvent(const TraceRing& ring, const TraceEvent& event)
+		{
+			std::fprintf(file_, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f",
+			             firstEvent_ ? "" : ",", event.name, event.phase, ring.id, event.start / 1000.0);
+
+			if (event.phase == 'X') std::fprintf(file_, ",\"dur\":%.3f", event.duration / 1000.0);
+			if (event.phase == 'i') std::fprintf(file_, ",\"s\":\"t\"");
+			if (event.phase == 'C') std::fprintf(file_, ",\"args\":{\"value\":%lld}", static_cast<long long>(event.value));
+
+			std::fprintf(file_, "}");
+
+			firstEvent_ = false;
+		}
+
+		void drainAll()
+		{
+			std::lock_guard<std::mutex> lock{ringsMutex_};
+
+			for (auto& ring : rings_)
+			{
+				ring->drain([this, &ring] (const TraceEvent& event) { writeEvent(*ring, event); });
+			}
+
+			std::fflush(file_);
+		}
+
+		void flusherLoop()
+		{
+			while (recording_.load())
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(FLUSH_PERIOD));
+
+				drainAll();
+			}
+		}
+
+	public:
+		Tracer() :
+			recording_  (false),
+			epoch_      (Clock::now()),
+			ringsMutex_ (),
+			rings_      (),
+			file_       (nullptr),
+			firstEvent_ (true),
+			flusher_    ()
+		{}
+
+		~Tracer() { stop(); }
+
+		static Tracer& instance()
+		{
+			static Tracer tracer;
+
+			return tracer;
+		}
+
+		bool recording() const { return recording_.load(std::memory_order_relaxed); }
+
+		uint64_t now() const
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_).count());
+		}
+
+		// The ring of the calling thread, created on the first event of the thread
+		TraceRing& ring()
+		{
+			thread_local TraceRing* ring = nullptr;
+
+			if (ring == nullptr)
+			{
+				std::lock_guard<std::mutex> lock{ringsMutex_};
+
+				rings_.emplace_back(new TraceRing{rings_.size() + 1});
+				ring = rings_.back().get();
+			}
+
+			return *ring;
+		}
+
+		void start(const std::string& path)
+		{
+			if (recording_.load()) return;
+
+			file_ = std::fopen(path.c_str(), "w");
+			if (file_ == nullptr)
+			{
+				throw VaExc::Exception(VAEXC_MSG("Trace: can't open %s", path.c_str()), VAEXC_POS);
+			}
+
+			std::fprintf(file_, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+			firstEvent_ = true;
+			epoch_      = Clock::now();
+
+			recording_.store(true);
+
+			flusher_ = std::thread{[this] { flusherLoop(); }};
+		}
+
+		// Writes what is left, the thread names and closes the file
+		void stop()
+		{
+			if (!recording_.exchange(false)) return;
+
+			flusher_.join();
+
+			drainAll();
+
+			std::lock_guard<std::mutex> lock{ringsMutex_};
+
+			uint64_t dropped = 0;
+
+			for (auto& ring : rings_)
+			{
+				dropped += ring->dropped.load();
+
+				if (ring->threadName.empty()) continue;
+
+				std::fprintf(file_, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+				             firstEvent_ ? "" : ",", ring->id, ring->threadName.c_str());
+
+				firstEvent_ = false;
+			}
+
+			std::fprintf(file_, "\n],\"otherData\":{\"droppedEvents\":%llu}}\n", static_cast<unsigned long long>(dropped));
+
+			std::fclose(file_);
+			file_ = nullptr;
+		}
+	};
+
+	// Records the time from construction to destruction as a complete event
+	class Scope
+	{
+	private:
+		const char* name_;
+		uint64_t    start_;
+
+	public:
+		explicit Scope(const char* name) :
+			name_  (Tracer::instance().recording() ? name : nullptr),
+			start_ (name_ != nullptr ? Tracer::instance().now() : 0)
+		{}
+
+		~Scope()
+		{
+			if (name_ == nullptr) return;
+
+			Tracer& tracer = Tracer::instance();
+
+			tracer.ring().push({name_, 'X', start_, tracer.now() - start_, 0});
+		}
+
+		Scope           (const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	inline void instant(const char* name)
+	{
+		Tracer& tracer = Tracer::instance();
+
+		if (tracer.recording()) tracer.ring().push({name, 'i', tracer.now(), 0, 0});
+	}
+
+	inline void counter(const char* name, int64_t value)
+	{
+		Tracer& tracer = Tracer::instance();
+
+		if (tracer.recording()) tracer.ring().push({name, 'C', tracer.now(), 0, value});
+	}
+
+	inline void threadName(const char* name)
+	{
+		Tracer::instance().ring().threadName = name;
+	}
+
+	inline void start(const std::string& path) { Tracer::instance().start(path); }
+	inline void stop()                         { Tracer::instance().stop(); }
+
+}  // namespace morse_trace
+
+#define MORSE_TRACE_CONCAT_(a, b) a##b
+#define MORSE_TRACE_CONCAT(a, b)  MORSE_TRACE_CONCAT_(a, b)
+
+#define MORSE_TRACE_SCOPE(name)          morse_trace::Scope MORSE_TRACE_CONCAT(morseTraceScope_, __LINE__){name}
+#define MORSE_TRACE_INSTANT(name)        morse_trace::instant(name)
+#define MORSE_TRACE_COUNTER(name, value) morse_trace::counter(name, static_cast<int64_t>(value))
+#define MORSE_TRACE_THREAD(name)         morse_trace::threadName(name)
+
+#else
+
+#include <string>
+
+namespace morse_trace
+{
+	const bool COMPILED_IN = false;
+
+	inline void start(const std::string&) {}
+	inline void stop() {}
+
+}  // namespace morse_trace
+
+#define MORSE_TRACE_SCOPE(name)
+#define MORSE_TRACE_INSTANT(name)
+#define MORSE_TRACE_COUNTER(name, value)
+#define MORSE_TRACE_THREAD(name)
+
+#endif  // MORSE_TRACE
+
+#endif  // HEADER_GUARD_BOOP_BEEPER_TRACE_HPP_INCLUDED
\ No newline at end of file